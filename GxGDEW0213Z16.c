@@ -1,143 +1,564 @@
 #include "GxGDEW0213Z16.h"
 #include "spi.h"
-#include "hal_delay.h"
 #include "epd_busy.h"
-#include "wdt.h"
-#include "uart.h"
-#include "hello.h"
+#include "assets.h"
+#include "systime.h"
+#include "sched.h"
+#include "fb.h"
+#include "temp.h"
 
-static void SendCommand(uint8_t reg)
+/* -----------------------------------------------------------------------
+ * Panel sequencer
+ *
+ * Every panel operation is a chain of steps run from scheduler events;
+ * nothing here waits. Between steps the sequencer is in one of the wait
+ * states:
+ *
+ *   EPD_OFF        after boot or in deep sleep (0x07), needs a hw reset
+ *   EPD_READY      powered, idle timer running
+ *   EPD_DELAY      EV_EPD_TIMER, then epd_next
+ *   EPD_WAIT_BUSY  EV_EPD_BUSY or the timeout, settle_ms, epd_next
+ *   EPD_SEND       EPD_ROWS_PER_STEP rows per EV_EPD_STEP
+ *
+ * A frame (EPD_SendRows) powers up if needed, streams the rows, posts
+ * EV_EPD_SENT, refreshes and posts EV_EPD_DONE. It leaves the panel
+ * powered so back-to-back frames skip the reset, booster soft start and
+ * power-on BUSY wait; after EPD_IDLE_TIMEOUT_MS the panel powers off
+ * and enters deep sleep. A frame queued meanwhile starts right after.
+ *
+ * What goes to the panel in each phase is a sequence (see below), the
+ * steps only order them.
+ * ----------------------------------------------------------------------- */
+#define EPD_OFF            0
+#define EPD_READY          1
+#define EPD_DELAY          2
+#define EPD_WAIT_BUSY      3
+#define EPD_SEND           4
+
+/* Steps, run once on entry */
+#define EPD_POWER_UP       10   /* EPD_SEQ_INIT */
+#define EPD_POWERED        11   /* SPI calibration if pending */
+#define EPD_START          12   /* EPD_SEQ_FRAME */
+#define EPD_ROWS           13   /* first rows */
+#define EPD_REFRESH        14   /* EPD_SEQ_REFRESH */
+#define EPD_DONE           15
+#define EPD_POWER_OFF      16   /* EPD_SEQ_SLEEP */
+#define EPD_ASLEEP         17
+#define EPD_SEQ            18   /* next op of the sequence */
+
+#define EPD_BUSY_TIMEOUT_MS 10000
+#define EPD_ROWS_PER_STEP   4    /* ~0.3 ms, the RX ring holds ~2.8 ms */
+
+/* -----------------------------------------------------------------------
+ * Temperature bands
+ *
+ * The OTP holds one waveform per temperature range and the controller
+ * picks it from its temperature register. Every frame the CC2530's
+ * sensor (temp.h) is read and written there (0xE0 TSFIX, 0xE5), so the
+ * panel runs the waveform for the actual temperature instead of its
+ * power-on default. The band also sets the pads around the refresh,
+ * which only the cold waveforms need in full. The frame rate stays at
+ * the power-on 50 Hz (0x30 = 0x3C) in every band: the OTP waveforms are
+ * timed for it, a faster PLL shortens every phase and leaves ghosting.
+ * ----------------------------------------------------------------------- */
+typedef struct {
+    int8_t  min_c;               /* from this temperature up */
+    uint8_t gap_ms;              /* before and after 0x12 */
+    uint8_t settle_ms;           /* after every BUSY wait */
+} epd_band_t;
+
+static __code const epd_band_t epd_bands[] = {
+    {   20,  20,  20 },          /* indoor */
+    {   10,  50, 100 },
+    { -128, 100, 200 },          /* cold: the old fixed pads */
+};
+
+static __code const epd_band_t *epd_band = &epd_bands[2];
+
+/* -----------------------------------------------------------------------
+ * Sequences
+ *
+ * The commands of each phase as byte code (ops in GxGDEW0213Z16.h),
+ * run by epd_seq_run() up to a wait, which goes through the sequencer's
+ * wait states and comes back to EPD_SEQ. A command and its data are one
+ * CS burst. Replacements uploaded with CMD_EPD_SEQ live in
+ * epd_seq_ram, epd_seq_at[id] is where (EPD_SEQ_BUILTIN: flash).
+ * ----------------------------------------------------------------------- */
+static __code const uint8_t epd_seq_init[] = {
+    EPD_SEQ_RESET, 0,
+    EPD_SEQ_DELAY, 10,
+    EPD_SEQ_RESET, 1,
+    EPD_SEQ_DELAY, 10,
+    EPD_SEQ_CMD + 3, 0x06, 0x17, 0x17, 0x17,    /* booster soft start */
+    EPD_SEQ_CMD + 0, 0x04,                      /* power on */
+    EPD_SEQ_WAIT_BUSY,
+    EPD_SEQ_CMD + 1, 0x00, 0x0F,                /* panel setting */
+    EPD_SEQ_CMD + 3, 0x61, 0x68, 0x00, 0xD4,    /* resolution 104 x 212 */
+    EPD_SEQ_CMD + 1, 0x50, 0x77,                /* VCOM and data interval */
+    EPD_SEQ_END,
+};
+
+static __code const uint8_t epd_seq_frame[] = {
+    EPD_SEQ_TEMP,
+    EPD_SEQ_CMD + 0, 0x13,                      /* rows follow */
+    EPD_SEQ_END,
+};
+
+static __code const uint8_t epd_seq_refresh[] = {
+    EPD_SEQ_GAP,
+    EPD_SEQ_CMD + 0, 0x12,
+    EPD_SEQ_GAP,
+    EPD_SEQ_WAIT_BUSY,
+    EPD_SEQ_END,
+};
+
+static __code const uint8_t epd_seq_sleep[] = {
+    EPD_SEQ_CMD + 0, 0x02,                      /* power off */
+    EPD_SEQ_WAIT_BUSY,
+    EPD_SEQ_CMD + 1, 0x07, 0xA5,                /* deep sleep, check code */
+    EPD_SEQ_END,
+};
+
+static __code const uint8_t * __code const epd_seqs[EPD_SEQS] = {
+    epd_seq_init, epd_seq_frame, epd_seq_refresh, epd_seq_sleep,
+};
+
+#define EPD_SEQ_BUILTIN    0xFF
+
+static __xdata uint8_t epd_seq_ram[EPD_SEQ_RAM];
+static __xdata uint8_t epd_seq_at[EPD_SEQS] = {
+    EPD_SEQ_BUILTIN, EPD_SEQ_BUILTIN, EPD_SEQ_BUILTIN, EPD_SEQ_BUILTIN,
+};
+
+static const uint8_t *epd_pc;           /* next op */
+static uint8_t epd_seq_next;            /* step after EPD_SEQ_END */
+
+/* -----------------------------------------------------------------------
+ * SPI clock calibration
+ *
+ * Frame transfer time scales with the SPI clock, and how fast a panel
+ * and its cable take it varies. After the first power-on (and on
+ * request, EPD_SpiCalibrate) the registers 0x70 (revision) and 0x71
+ * (status) are read back at every rate in spi.h, slowest first, and
+ * compared to a reference read at the slowest one. The command bytes go
+ * out at the rate under test; the reply is bit-banged, so it doesn't
+ * depend on it. The fastest rate whose EPD_CAL_ROUNDS reads all match
+ * is kept until the next reset. A panel that does not answer (no PON
+ * in the status) keeps SPI_RATE_DEFAULT.
+ * ----------------------------------------------------------------------- */
+#define EPD_CAL_ROUNDS     16
+#define EPD_FLG_PON        0x04  /* 0x71: power is on */
+
+static __xdata epd_spi_cal_t epd_cal;
+
+static uint8_t  epd_state = EPD_OFF;
+static uint8_t  epd_next;
+static uint8_t  epd_y;
+static epd_row_fn epd_job;              /* frame queued or being sent */
+static uint8_t  epd_sending;
+
+static __xdata uint8_t *epd_frame;
+static int8_t   epd_temp;
+
+__xdata uint8_t epd_row[EPD_ROW_BYTES];
+
+/* -----------------------------------------------------------------------
+ * Command (DC low) and n data bytes (DC high) in one CS burst
+ * ----------------------------------------------------------------------- */
+static void SendCommand(uint8_t reg, const uint8_t *data, uint8_t n) NONBANKED
 {
     SPI_DC_LOW();
     SPI_CS_LOW();
     DEV_SPI_WriteByte(reg);
+    SPI_DC_HIGH();
+    SPI_WriteBytes(data, n, 0);
     SPI_CS_HIGH();
 }
 
-/* -----------------------------------------------------------------------
- * Send data (DC high)
- * ----------------------------------------------------------------------- */
-static void SendData(uint8_t data)
+static void epd_delay(uint16_t ms, uint8_t next)
+{
+    epd_state = EPD_DELAY;
+    epd_next  = next;
+    sched_timer_start(EV_EPD_TIMER, SYSTIME_MS(ms));
+}
+
+/* 0x71 (get status) and wait for BUSY to go away. The edge interrupt
+ * may have fired already, so the pin is checked once right away. */
+static void epd_wait_busy(uint8_t next)
+{
+    SendCommand(0x71, 0, 0);
+    epd_state = EPD_WAIT_BUSY;
+    epd_next  = next;
+    sched_timer_start(EV_EPD_TIMER, SYSTIME_MS(EPD_BUSY_TIMEOUT_MS));
+    SCHED_POST(EV_EPD_BUSY);
+}
+
+/* Read the sensor, pick the band and hand the temperature to the panel */
+static void epd_temperature(void)
+{
+    static __code const uint8_t tsfix = 0x02;
+
+    epd_temp = temp_read();
+    for (epd_band = epd_bands; epd_temp < epd_band->min_c; epd_band++);
+
+    // Fixed temperature from 0xE5 instead of the sensor input
+    SendCommand(0xE0, &tsfix, 1);
+    SendCommand(0xE5, (const uint8_t *)&epd_temp, 1);
+}
+
+static uint8_t epd_seq(uint8_t id, uint8_t next)
+{
+    uint8_t at = epd_seq_at[id];
+
+    epd_pc       = at == EPD_SEQ_BUILTIN ? epd_seqs[id] : epd_seq_ram + at;
+    epd_seq_next = next;
+    return EPD_SEQ;
+}
+
+/* Ops up to a wait (returns 0) or the end (returns epd_seq_next) */
+static uint8_t epd_seq_run(void)
+{
+    uint8_t op, n;
+
+    while (1) {
+        op = *epd_pc++;
+        if (op < EPD_SEQ_DELAY) {
+            n = op & 0x0F;
+            if (op < EPD_SEQ_DATA) {
+                SendCommand(*epd_pc, epd_pc + 1, n);
+                epd_pc++;
+            } else {
+                SPI_DC_HIGH();
+                SPI_CS_LOW();
+                SPI_WriteBytes(epd_pc, n, 0);
+                SPI_CS_HIGH();
+            }
+            epd_pc += n;
+            continue;
+        }
+
+        switch (op) {
+        case EPD_SEQ_DELAY:
+            epd_delay(*epd_pc++, EPD_SEQ);
+            return 0;
+
+        case EPD_SEQ_GAP:
+            epd_delay(epd_band->gap_ms, EPD_SEQ);
+            return 0;
+
+        case EPD_SEQ_WAIT_BUSY:
+            epd_wait_busy(EPD_SEQ);
+            return 0;
+
+        case EPD_SEQ_RESET:
+            if (*epd_pc++)
+                SPI_RST_HIGH();
+            else
+                SPI_RST_LOW();
+            break;
+
+        case EPD_SEQ_TEMP:
+            epd_temperature();
+            break;
+
+        default:                        /* EPD_SEQ_END */
+            return epd_seq_next;
+        }
+    }
+}
+
+static uint8_t epd_cal_read(__xdata uint8_t *buf)
+{
+    SPI_ReadRegister(0x70, buf, EPD_REV_LEN);
+    SPI_ReadRegister(0x71, buf + EPD_CAL_STATUS, 1);
+    return buf[EPD_CAL_STATUS];
+}
+
+/* Panel powered on and idle */
+static void epd_spi_calibrate(void)
+{
+    static __xdata uint8_t got[EPD_REV_LEN + 1];
+    uint8_t rate, n, i;
+
+    SPI_SetRate(0);
+    epd_cal.passed = 0;
+    n = epd_cal_read(epd_cal.reg);
+    if (n == 0xFF || !(n & EPD_FLG_PON)) {
+        epd_cal.state = EPD_CAL_NO_REPLY;
+        SPI_SetRate(SPI_RATE_DEFAULT);
+        return;
+    }
+
+    for (rate = 0; rate < SPI_RATES; rate++) {
+        SPI_SetRate(rate);
+        for (n = 0; n < EPD_CAL_ROUNDS; n++) {
+            epd_cal_read(got);
+            for (i = 0; i <= EPD_REV_LEN && got[i] == epd_cal.reg[i]; i++);
+            if (i <= EPD_REV_LEN)
+                break;
+        }
+        if (n < EPD_CAL_ROUNDS)
+            break;
+        epd_cal.passed |= 1 << rate;
+    }
+
+    /* rate 0 failing against its own reference: too noisy to tell */
+    SPI_SetRate(rate ? rate - 1 : SPI_RATE_DEFAULT);
+    epd_cal.state = rate ? EPD_CAL_DONE : EPD_CAL_NO_REPLY;
+}
+
+/* Run step and the steps that follow it without waiting */
+static void epd_enter(uint8_t step)
+{
+    uint8_t cur;
+
+    while (step) {
+        cur  = step;
+        step = 0;
+        switch (cur) {
+        case EPD_SEQ:
+            step = epd_seq_run();
+            break;
+
+        case EPD_POWER_UP:
+            step = epd_seq(EPD_SEQ_INIT, EPD_POWERED);
+            break;
+
+        case EPD_POWERED:
+            if (epd_cal.state == EPD_CAL_PENDING)
+                epd_spi_calibrate();
+            step = epd_job ? EPD_START : EPD_READY;
+            break;
+
+        case EPD_START:
+            step = epd_seq(EPD_SEQ_FRAME, EPD_ROWS);
+            break;
+
+        case EPD_ROWS:
+            epd_y     = 0;
+            epd_state = EPD_SEND;
+            SCHED_POST(EV_EPD_STEP);
+            break;
+
+        case EPD_REFRESH:
+            step = epd_seq(EPD_SEQ_REFRESH, EPD_DONE);
+            break;
+
+        case EPD_DONE:
+            epd_job = 0;
+            SCHED_POST(EV_EPD_DONE);
+            step = EPD_READY;
+            break;
+
+        case EPD_READY:
+            epd_state = EPD_READY;
+            if (epd_job)
+                step = EPD_START;
+            else
+                sched_timer_start(EV_EPD_TIMER, SYSTIME_MS(EPD_IDLE_TIMEOUT_MS));
+            break;
+
+        case EPD_POWER_OFF:
+            step = epd_seq(EPD_SEQ_SLEEP, EPD_ASLEEP);
+            break;
+
+        case EPD_ASLEEP:
+            epd_state = EPD_OFF;
+            if (epd_job)
+                step = EPD_POWER_UP;
+            break;
+        }
+    }
+}
+
+/* Rows of the frame, sent inverted: 0xff shows grey, 0x00 white. The
+ * rows of a step are one burst. */
+static void epd_send_rows(void)
 {
+    uint8_t n;
+
     SPI_DC_HIGH();
     SPI_CS_LOW();
-    DEV_SPI_WriteByte(data);
+    for (n = 0; n < EPD_ROWS_PER_STEP && epd_y < EPD_HEIGHT; n++, epd_y++) {
+        epd_job(epd_y);
+        SPI_WriteBytes(epd_row, EPD_ROW_BYTES, 0xFF);
+    }
     SPI_CS_HIGH();
+
+    if (epd_y < EPD_HEIGHT) {
+        SCHED_POST(EV_EPD_STEP);
+        return;
+    }
+    epd_sending = 0;
+    SCHED_POST(EV_EPD_SENT);
+    epd_enter(EPD_REFRESH);
 }
 
-void WaitBusy(void)
-{
-    uint16_t timeout = 0;
-    SendCommand(0x71);
-    // uart_printf("BUSY pin = %u\n", (uint16_t)EPD_Busy());
-    while (EPD_Busy()) {
-        WDT_FEED();
-        HAL_Delay(10);
-        // timeout++;
-        // if (timeout % 100 == 0)   /* print every 1 second */
-        //     uart_printf("still busy... %u00ms pin=%u\n",
-        //                 timeout / 100, (uint16_t)EPD_Busy());
-        // if (timeout >= 1000) {     /* 10 second hard timeout */
-        //     uart_printf("BUSY timeout! giving up\n");
-        //     break;
-        // }
-
-        if (timeout >= 1000) break;
+/* EV_EPD_BUSY, EV_EPD_TIMER and EV_EPD_STEP */
+static void epd_run(void) NONBANKED
+{
+    switch (epd_state) {
+    case EPD_DELAY:
+        if (!sched_timer_armed(EV_EPD_TIMER))
+            epd_enter(epd_next);
+        break;
+
+    case EPD_WAIT_BUSY:
+        /* a timeout goes on regardless, like the old blocking wait */
+        if (EPD_Busy() && sched_timer_armed(EV_EPD_TIMER))
+            break;
+        sched_timer_stop(EV_EPD_TIMER);
+        epd_delay(epd_band->settle_ms, epd_next);
+        break;
+
+    case EPD_SEND:
+        epd_send_rows();
+        break;
+
+    case EPD_READY:
+        if (!sched_timer_armed(EV_EPD_TIMER))
+            epd_enter(EPD_POWER_OFF);
+        break;
     }
-    // uart_printf("BUSY done, pin = %u\n", (uint16_t)EPD_Busy());
-    HAL_Delay(200);
 }
 
 void EPD_Init(void)
 {
-    // Hardware reset
-    SPI_RST_LOW();
-    HAL_Delay(10);
-    SPI_RST_HIGH();
-    HAL_Delay(10);
-
-    // Booster soft start
-    SendCommand(0x06);
-    SendData(0x17);
-    SendData(0x17);
-    SendData(0x17);
+    epd_state   = EPD_OFF;
+    epd_job     = 0;
+    epd_sending = 0;
+    epd_cal.state = EPD_CAL_PENDING;
+    sched_on(EV_EPD_BUSY,  epd_run);
+    sched_on(EV_EPD_TIMER, epd_run);
+    sched_on(EV_EPD_STEP,  epd_run);
+    epd_enter(EPD_POWER_UP);
+}
 
-    // Power on
-    SendCommand(0x04);
-    WaitBusy();
+void EPD_Sleep(void)
+{
+    if (epd_state == EPD_READY && !epd_job) {
+        sched_timer_stop(EV_EPD_TIMER);
+        epd_enter(EPD_POWER_OFF);
+    }
+}
 
-    // Panel setting
-    SendCommand(0x00);
-    SendData(0x0F);
-    
-    // Resolution setting (104 x 212)
-    SendCommand(0x61);
-    SendData(0x68);   // 104
-    SendData(0x00);
-    SendData(0xD4);   // 212
+uint8_t EPD_Idle(void)
+{
+    return epd_job == 0;
+}
 
-    // VCOM and data interval
-    SendCommand(0x50);
-    SendData(0x77);
+uint8_t EPD_Sending(void)
+{
+    return epd_sending;
+}
 
+int8_t EPD_Temperature(void)
+{
+    return epd_temp;
 }
 
-void EPD_Refresh(void) {
-    HAL_Delay(100);
-    SendCommand(0x12);
-    HAL_Delay(100);
-    WaitBusy();
+void EPD_SpiCalibrate(void)
+{
+    epd_cal.state = EPD_CAL_PENDING;
+    if (epd_state == EPD_READY && !epd_job)
+        epd_spi_calibrate();
 }
 
-#define BUFFER_SIZE 2756 // 104*212 / 8
+__xdata epd_spi_cal_t *EPD_SpiCal(void)
+{
+    return &epd_cal;
+}
 
-void EPD_Clear(void)
+/* Not while a sequence may be running from epd_seq_ram */
+__xdata uint8_t *EPD_SeqBuffer(void)
 {
-    EPD_Init();
+    uint8_t id;
 
-    SendCommand(0x13);
-    for (uint32_t i = 0; i < BUFFER_SIZE; i++)
-        SendData(0x00); // 0xff will show grey, 0x00 will show white
+    if (epd_state != EPD_OFF && epd_state != EPD_READY)
+        return 0;
+    for (id = 0; id < EPD_SEQS; id++)
+        epd_seq_at[id] = EPD_SEQ_BUILTIN;
+    return epd_seq_ram;
+}
 
-    EPD_Refresh();
+/* Every op complete and known, every sequence ended, nothing after the
+ * last one. Sets epd_seq_at on the way. */
+static uint8_t epd_seq_parse(uint16_t len)
+{
+    uint16_t i = 0, start;
+    uint8_t  id, op;
 
-    // Sleep
-    SendCommand(0x02);
-    WaitBusy();
+    for (id = 0; id < EPD_SEQS && i < len; id++) {
+        start = i;
+        do {
+            if (i >= len)
+                return 0;
+            op = epd_seq_ram[i++];
+            if (op < EPD_SEQ_DATA)
+                i += (op & 0x0F) + 1;
+            else if (op < EPD_SEQ_DELAY)
+                i += op & 0x0F;
+            else if (op == EPD_SEQ_DELAY || op == EPD_SEQ_RESET)
+                i++;
+            else if (op > EPD_SEQ_TEMP && op != EPD_SEQ_END)
+                return 0;
+        } while (op != EPD_SEQ_END);
+        if (i - start > 1)
+            epd_seq_at[id] = start;
+    }
+    return i == len;
 }
 
-void EPD_Test(void) 
+uint8_t EPD_SeqLoad(uint16_t len)
 {
-    // SendCommand(0x10);
-    // for (uint32_t i = 0; i < BUFFER_SIZE; i++)
-    //     SendData(~black[i]);
+    uint8_t id;
 
-    SendCommand(0x13);
-    for (uint32_t i = 0; i < BUFFER_SIZE; i++)
-        SendData(0x00);
+    if (epd_seq_parse(len))
+        return 1;
+    for (id = 0; id < EPD_SEQS; id++)
+        epd_seq_at[id] = EPD_SEQ_BUILTIN;
+    return 0;
+}
 
-    EPD_Refresh();
+/* Frame generated row by row while it is sent, no framebuffer needed */
+void EPD_SendRows(epd_row_fn row_fn)
+{
+    epd_job     = row_fn;
+    epd_sending = 1;
 
-    SendCommand(0x13);
-    for (uint32_t i = 0; i < BUFFER_SIZE; i++)
-        SendData(~test1[i]);
+    if (epd_state == EPD_OFF) {
+        epd_enter(EPD_POWER_UP);
+    } else if (epd_state == EPD_READY) {
+        sched_timer_stop(EV_EPD_TIMER);
+        epd_enter(EPD_START);
+    }
+    /* else powering up or down, picked up when that is done */
+}
 
-    EPD_Refresh();
+static void clear_row(uint8_t y) NONBANKED
+{
+    (void)y;
+    fb_fill(epd_row, 0xFF, EPD_ROW_BYTES);
+}
 
-    // Sleep
-    SendCommand(0x02);
-    WaitBusy();
+static void frame_row(uint8_t y) NONBANKED
+{
+    fb_copy(epd_row, epd_frame + (uint16_t)y * EPD_ROW_BYTES, EPD_ROW_BYTES);
 }
 
-void EPD_SendFrame(uint8_t *framebuffer)
+void EPD_Clear(void)
 {
-    EPD_Init(); // hwreset after sleep
+    EPD_SendRows(clear_row);
+}
 
-    SendCommand(0x13);
-    for (uint32_t i = 0; i < BUFFER_SIZE; i++)
-        SendData(~framebuffer[i]);
+void EPD_SendFrame(__xdata uint8_t *framebuffer)
+{
+    epd_frame = framebuffer;
+    EPD_SendRows(frame_row);
+}
 
-    EPD_Refresh();
-    SendCommand(0x02);
-    WaitBusy();
+void EPD_Test(void)
+{
+    asset_open(ASSET_TEST1);
+    EPD_SendRows(asset_row);
 }
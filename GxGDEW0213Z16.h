@@ -2,10 +2,102 @@
 #define GXGDEW0213Z16_H
 
 #include <stdint.h>
+#include "bank.h"
 
+/* Keep the panel powered this long after the last update */
+#define EPD_IDLE_TIMEOUT_MS 5000
+
+/* Panel geometry as scanned by the 0x13 data stream */
+#define EPD_WIDTH      104
+#define EPD_HEIGHT     212
+#define EPD_ROW_BYTES  (EPD_WIDTH / 8)
+
+/*
+ * Row generator for EPD_SendRows(): fills epd_row with panel row y in
+ * framebuffer polarity (1 = white). One argument only, SDCC calls
+ * through function pointers are not reentrant. NONBANKED, see bank.h.
+ */
+typedef void (*epd_row_fn)(uint8_t y) NONBANKED;
+extern __xdata uint8_t epd_row[EPD_ROW_BYTES];
+
+/*
+ * Non-blocking, run by the scheduler (sched.h). EPD_Init() starts the
+ * power-up sequence. A frame is queued with EPD_Clear(), EPD_SendFrame()
+ * or EPD_SendRows() while EPD_Idle(); its source is read until
+ * EV_EPD_SENT and EV_EPD_DONE follows when the refresh is done.
+ */
 void EPD_Init(void);
 void EPD_Clear(void);
 void EPD_Test(void);
-void EPD_SendFrame(uint8_t *framebuffer);
+void EPD_SendFrame(__xdata uint8_t *framebuffer);
+void EPD_SendRows(epd_row_fn row_fn);
+void EPD_Sleep(void);
+uint8_t EPD_Idle(void);       /* no frame queued or being drawn */
+uint8_t EPD_Sending(void);    /* the frame's source is still being read */
+int8_t EPD_Temperature(void); /* degrees C at the last frame, see temp.h */
+
+/*
+ * SPI clock calibration (GxGDEW0213Z16.c). EPD_SpiCalibrate() runs it
+ * now if the panel is powered and idle, else at the next power-up;
+ * it also runs once after boot.
+ */
+#define EPD_REV_LEN        4     /* bytes read from 0x70 */
+#define EPD_CAL_STATUS     EPD_REV_LEN   /* 0x71 in epd_spi_cal_t.reg */
+
+#define EPD_CAL_PENDING    0
+#define EPD_CAL_DONE       1
+#define EPD_CAL_NO_REPLY   2     /* reads unusable, SPI_RATE_DEFAULT kept */
+
+typedef struct {
+    uint8_t state;               /* EPD_CAL_* */
+    uint8_t passed;              /* bit n: SPI rate n read back right */
+    uint8_t reg[EPD_REV_LEN + 1];  /* reference read: 0x70, then 0x71 */
+} epd_spi_cal_t;
+
+void EPD_SpiCalibrate(void);
+__xdata epd_spi_cal_t *EPD_SpiCal(void);
+
+/*
+ * Panel sequences, byte code run by the sequencer (GxGDEW0213Z16.c):
+ *
+ *   EPD_SEQ_CMD + n, cmd, n bytes   command and n (0-15) data bytes,
+ *                                   one CS burst
+ *   EPD_SEQ_DATA + n, n bytes       more data for the last command
+ *   EPD_SEQ_DELAY, ms
+ *   EPD_SEQ_GAP                     the temperature band's pad
+ *   EPD_SEQ_WAIT_BUSY               0x71, BUSY, the band's settle time
+ *   EPD_SEQ_RESET, level            RST pin
+ *   EPD_SEQ_TEMP                    sensor -> band, 0xE0/0xE5
+ *   EPD_SEQ_END
+ *
+ * EPD_SEQ_INIT runs after a reset or deep sleep, EPD_SEQ_FRAME before
+ * the rows (which follow as 0x13 data), EPD_SEQ_REFRESH after them and
+ * EPD_SEQ_SLEEP once the panel has been idle. The built-in ones are in
+ * flash; CMD_EPD_SEQ replaces them until the next reset:
+ * EPD_SeqBuffer() is where the new set goes, up to EPD_SEQ_RAM bytes
+ * (or 0 while a sequence is running, try again), and the built-ins are
+ * used until EPD_SeqLoad(len) has checked it. The set holds the
+ * sequences in the order above, each up to its END; one that is only
+ * END, and those missing at the end, stay built-in.
+ */
+#define EPD_SEQ_CMD        0x00
+#define EPD_SEQ_DATA       0x10
+#define EPD_SEQ_DELAY      0x20
+#define EPD_SEQ_GAP        0x21
+#define EPD_SEQ_WAIT_BUSY  0x22
+#define EPD_SEQ_RESET      0x23
+#define EPD_SEQ_TEMP       0x24
+#define EPD_SEQ_END        0xFF
+
+#define EPD_SEQ_INIT       0
+#define EPD_SEQ_FRAME      1
+#define EPD_SEQ_REFRESH    2
+#define EPD_SEQ_SLEEP      3
+#define EPD_SEQS           4
+
+#define EPD_SEQ_RAM        256
+
+__xdata uint8_t *EPD_SeqBuffer(void);
+uint8_t EPD_SeqLoad(uint16_t len);
 
-#endif
\ No newline at end of file
+#endif
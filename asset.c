@@ -0,0 +1,67 @@
+#include <cc2530.h>
+#include <stdint.h>
+#include "assets.h"
+#include "GxGDEW0213Z16.h"
+
+/* Reader state, rd_src points into the XDATA flash window (asset.h) */
+static __xdata const uint8_t * HOT_VAR rd_src;
+static HOT_VAR uint8_t rd_bank;
+static HOT_VAR uint8_t rd_enc;
+static HOT_VAR uint8_t rd_count;      /* bytes left in the current packet */
+static HOT_VAR uint8_t rd_run;        /* current packet is a run */
+static HOT_VAR uint8_t rd_value;
+
+void asset_open(uint8_t id)
+{
+#ifndef SIM
+    rd_src   = (__xdata const uint8_t *)(0x8000 | (uint16_t)assets[id].data);
+#else
+    rd_src   = assets[id].data;
+#endif
+    rd_bank  = assets[id].bank;
+    rd_enc   = assets[id].enc;
+    rd_count = 0;
+}
+
+/* -----------------------------------------------------------------------
+ * Next len bytes of the open asset
+ * ----------------------------------------------------------------------- */
+void asset_read(__xdata uint8_t *dst, uint8_t len) NONBANKED
+{
+    uint8_t n;
+#ifndef SIM
+    uint8_t memctr = MEMCTR;
+
+    MEMCTR = (memctr & ~0x07) | rd_bank;
+#endif
+
+    if (rd_enc == ASSET_ENC_RAW) {
+        while (len--)
+            *dst++ = *rd_src++;
+    } else {
+        while (len--) {
+            while (!rd_count) {
+                n = *rd_src++;
+                if (n < 128) {
+                    rd_count = n + 1;
+                    rd_run   = 0;
+                } else if (n > 128) {
+                    rd_count = 257 - n;
+                    rd_run   = 1;
+                    rd_value = *rd_src++;
+                }                             /* 128 is a no-op */
+            }
+            *dst++ = rd_run ? rd_value : *rd_src++;
+            rd_count--;
+        }
+    }
+#ifndef SIM
+    MEMCTR = memctr;
+#endif
+}
+
+void asset_row(uint8_t y) NONBANKED
+{
+    (void)y;
+    asset_read(epd_row, EPD_ROW_BYTES);
+}
@@ -0,0 +1,43 @@
+#ifndef ASSET_H
+#define ASSET_H
+
+#include <stdint.h>
+#include "bank.h"
+
+/*
+ * Flash assets compiled from the PNGs in assets/ by host_script/assets.py into
+ * out/assets.c, indexed by the ASSET_* ids in out/assets.h.
+ *
+ *   ASSET_KIND_FRAME  w x h framebuffer (1 = white), raw or PackBits
+ *   ASSET_KIND_FONT   96 glyphs from 0x20, w column bytes each, raw
+ *
+ * In banked builds frame data is placed in the flash banks ASSET_BANKS
+ * (Makefile) and read through the XDATA window at 0x8000 with MEMCTR
+ * XBANK set to the asset's bank; data holds the low 16 bits of its
+ * linker address. Fonts stay in the common area (bank 0), text.c reads
+ * their glyphs as __code.
+ */
+#define ASSET_KIND_FRAME    0
+#define ASSET_KIND_FONT     1
+
+#define ASSET_ENC_RAW       0
+#define ASSET_ENC_PACKBITS  1         /* n<128: n+1 literals, n>128: run of 257-n */
+
+typedef struct {
+    uint8_t  kind;
+    uint8_t  enc;
+    uint8_t  w, h;
+    uint16_t size;                    /* bytes in flash */
+    uint8_t  bank;                    /* flash bank, 0 = common area */
+    __code const uint8_t *data;
+} asset_t;
+
+/*
+ * Sequential reader, decompresses on the fly. There is one, frames are
+ * only ever streamed to the panel one at a time.
+ */
+void asset_open(uint8_t id);
+void asset_read(__xdata uint8_t *dst, uint8_t len) NONBANKED;
+void asset_row(uint8_t y) NONBANKED;            /* epd_row_fn, next row of the open frame */
+
+#endif /* ASSET_H */
@@ -0,0 +1,45 @@
+/*
+ * bank.c — banked call trampolines for make BANKED=1
+ *
+ * SDCC's huge model calls a banked function as
+ *
+ *     mov  r0, #<fn    mov  r1, #>fn    mov  r2, #bank(fn)
+ *     lcall __sdcc_banked_call
+ *
+ * and the function returns through __sdcc_banked_ret. The library
+ * versions switch banks through a PSBANK register; on the CC2530 the
+ * bank shown at 0x8000-0xFFFF is FMAP, so these replace them. Linked
+ * into the common area, this file must not be in any BANKn_SRCS.
+ */
+
+#include <cc2530.h>
+#include "bank.h"
+
+#if defined(__SDCC_MODEL_HUGE)
+
+void bank_trampolines(void) __naked
+{
+    __asm
+        .globl  __sdcc_banked_call
+        .globl  __sdcc_banked_ret
+
+    ; stack on entry: return address of the caller
+__sdcc_banked_call:
+        push    _FMAP           ; bank to return to
+        xch     a, r0           ; keep A, r0 = low byte of the target
+        push    acc
+        mov     a, r1
+        push    acc             ; target address, ret jumps there
+        mov     a, r2
+        anl     a, #0x07        ; bank number, drop SDCC's storage bits
+        mov     _FMAP, a
+        xch     a, r0           ; restore A
+        ret
+
+__sdcc_banked_ret:
+        pop     _FMAP           ; caller's bank
+        ret
+    __endasm;
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef BANK_H
+#define BANK_H
+
+/*
+ * Code and data placement
+ *
+ * Banked builds (make BANKED=1, SDCC --model-huge)
+ *
+ * Code in BANKn_SRCS (see Makefile) is linked into a 32 KB flash bank,
+ * visible at 0x8000-0xFFFF when FMAP selects it. Everything else stays
+ * in the common area 0x0000-0x7FFF. Calls into banked code go through
+ * __sdcc_banked_call (bank.c), which saves and switches FMAP, about 30
+ * cycles per call and return.
+ *
+ * NONBANKED functions are called with a plain lcall. Use it for:
+ *   - per-byte hot paths (SPI/UART byte I/O, row generators, CRC)
+ *   - interrupt handlers and anything called through a function pointer
+ *   - code that changes FMAP itself
+ * A NONBANKED function must be in a file that stays in the common area.
+ * Constant data (__code tables, strings) is in the common area too,
+ * except frame assets: those go into the ASSET_BANKS banks and are read
+ * through the XDATA flash window, see asset.h.
+ */
+#if defined(__SDCC_MODEL_HUGE)
+#define NONBANKED  __nonbanked
+#else
+#define NONBANKED
+#endif
+
+/*
+ * HOT_VAR is the storage class of the few variables touched per byte or
+ * per panel row (asset reader, text layout, overlay count). Empty means
+ * the memory model's default. make HOT=data or HOT=xdata overrides it,
+ * see make matrix.
+ */
+#ifndef HOT_VAR
+#define HOT_VAR
+#endif
+
+#endif /* BANK_H */
@@ -0,0 +1,185 @@
+#ifdef BENCH
+
+#include <cc2530.h>
+#include <stdint.h>
+#include "bench.h"
+#include "uart.h"
+#include "uart_rx.h"
+#include "spi.h"
+#include "crc32.h"
+#include "assets.h"
+#include "text.h"
+#include "compose.h"
+#include "fb.h"
+#include "GxGDEW0213Z16.h"
+
+typedef struct {
+    uint16_t calls;
+    uint32_t cycles;
+} bench_result_t;
+
+static __xdata bench_result_t results[BENCH_COUNT];
+static uint16_t overhead;
+
+/* Reading T1CNTL latches T1CNTH */
+static uint16_t ticks(void)
+{
+    uint8_t lo = T1CNTL;
+    return ((uint16_t)T1CNTH << 8) | lo;
+}
+
+static void bench_add(uint8_t id, uint16_t t)
+{
+    results[id].calls++;
+    results[id].cycles += t > overhead ? t - overhead : 0;
+}
+
+#define BENCH_TIME(id, stmt)             \
+    do {                                 \
+        uint16_t t0 = ticks();           \
+        stmt;                            \
+        bench_add(id, ticks() - t0);     \
+    } while (0)
+
+/* A PackBits frame if there is one, it is the slower path */
+static uint8_t packed_asset(void)
+{
+    uint8_t id;
+    for (id = 0; id < ASSET_COUNT; id++)
+        if (assets[id].kind == ASSET_KIND_FRAME &&
+            assets[id].enc == ASSET_ENC_PACKBITS)
+            return id;
+    return 0;
+}
+
+/* -----------------------------------------------------------------------
+ * Plain C loops for fb.h to beat
+ * ----------------------------------------------------------------------- */
+static void c_fill(__xdata uint8_t *dst, uint8_t value, uint16_t len)
+{
+    while (len--)
+        *dst++ = value;
+}
+
+static void c_copy(__xdata uint8_t *dst, __xdata const uint8_t *src,
+                   uint16_t len)
+{
+    while (len--)
+        *dst++ = *src++;
+}
+
+static void c_copy_code(__xdata uint8_t *dst, __code const uint8_t *src,
+                        uint16_t len)
+{
+    while (len--)
+        *dst++ = *src++;
+}
+
+static void c_invert(__xdata uint8_t *dst, uint16_t len)
+{
+    while (len--) {
+        *dst = ~*dst;
+        dst++;
+    }
+}
+
+static void c_xor(__xdata uint8_t *dst, __xdata const uint8_t *src,
+                  uint16_t len)
+{
+    while (len--)
+        *dst++ ^= *src++;
+}
+
+static void bench_fb(void)
+{
+    __xdata uint8_t *a = framebuffer;
+    __xdata uint8_t *b = framebuffer + BENCH_FB_LEN;
+    __code const uint8_t *flash = assets[ASSET_FONT5X7].data;   /* common area */
+    uint16_t n = BENCH_FB_LEN;
+    uint8_t  i;
+
+    if (assets[ASSET_FONT5X7].size < n)
+        n = assets[ASSET_FONT5X7].size;
+
+    for (i = 0; i < 4; i++) {
+        BENCH_TIME(BENCH_FILL_C,     c_fill(a, 0x55, BENCH_FB_LEN));
+        BENCH_TIME(BENCH_FILL_CPU,   fb_cpu_fill(a, 0x55, BENCH_FB_LEN));
+        BENCH_TIME(BENCH_FILL_DMA,   fb_dma_fill(a, 0x55, BENCH_FB_LEN));
+        BENCH_TIME(BENCH_COPY_C,     c_copy(b, a, BENCH_FB_LEN));
+        BENCH_TIME(BENCH_COPY_CPU,   fb_cpu_copy(b, a, BENCH_FB_LEN));
+        BENCH_TIME(BENCH_COPY_DMA,   fb_dma_copy(b, (uint16_t)a, BENCH_FB_LEN));
+        BENCH_TIME(BENCH_CODE_C,     c_copy_code(b, flash, n));
+        BENCH_TIME(BENCH_CODE_DMA,   fb_copy_code(b, flash, n));
+        BENCH_TIME(BENCH_INVERT_C,   c_invert(a, BENCH_FB_LEN));
+        BENCH_TIME(BENCH_INVERT_CPU, fb_invert(a, BENCH_FB_LEN));
+        BENCH_TIME(BENCH_XOR_C,      c_xor(b, a, BENCH_FB_LEN));
+        BENCH_TIME(BENCH_XOR_CPU,    fb_xor(b, a, BENCH_FB_LEN));
+    }
+
+    for (i = 0; i < 32; i++) {
+        BENCH_TIME(BENCH_ROW_C,  c_copy(epd_row, a, EPD_ROW_BYTES));
+        BENCH_TIME(BENCH_ROW_FB, fb_copy(epd_row, a, EPD_ROW_BYTES));
+    }
+}
+
+void bench_run(void)
+{
+    uint16_t i, t;
+    uint8_t  y;
+
+    for (i = 0; i < BENCH_COUNT; i++) {
+        results[i].calls  = 0;
+        results[i].cycles = 0;
+    }
+
+    T1CTL = 0x01;                       /* tick /1, free-running */
+    t = ticks();
+    overhead = ticks() - t;
+
+    /* uart_getc: the host sends BENCH_RX_BYTES after the ACK */
+    uart_putc(0x06);
+    for (i = 0; i < BENCH_RX_BYTES; i++) {
+        while (!uart_rx_ready());
+        BENCH_TIME(BENCH_UART_GETC, uart_getc());
+    }
+
+    /* CS stays high, the panel ignores these */
+    SPI_CS_HIGH();
+    for (i = 0; i < 256; i++)
+        BENCH_TIME(BENCH_SPI_BYTE, DEV_SPI_WriteByte(0x00));
+    for (i = 0; i < 32; i++)
+        BENCH_TIME(BENCH_SPI_ROW, SPI_WriteBytes(epd_row, EPD_ROW_BYTES, 0xFF));
+
+    for (i = 0; i < 16; i++)
+        BENCH_TIME(BENCH_CRC32_64,
+                   crc32_update(CRC32_INIT, framebuffer + i * 64, 64));
+
+    asset_open(packed_asset());
+    for (y = 0; y < 32; y++)
+        BENCH_TIME(BENCH_ASSET_ROW, asset_row(y));
+
+    for (y = 0; y < 32; y++)
+        BENCH_TIME(BENCH_TEXT_ROW, text_row(y));
+
+    for (y = 0; y < 32; y++)
+        BENCH_TIME(BENCH_COMPOSE_ROW, compose_row(y));
+
+    bench_fb();
+
+    BENCH_TIME(BENCH_UART_PRINTF,
+               uart_printf("bench %u 0x%x\n", (uint16_t)overhead, 0xBEEF));
+
+    uart_putc(0x06);
+    uart_putb(BENCH_COUNT);
+    for (i = 0; i < BENCH_COUNT; i++) {
+        uart_putb(i);
+        uart_putb((uint8_t)results[i].calls);
+        uart_putb(results[i].calls >> 8);
+        uart_putb((uint8_t)results[i].cycles);
+        uart_putb((uint8_t)(results[i].cycles >> 8));
+        uart_putb((uint8_t)(results[i].cycles >> 16));
+        uart_putb((uint8_t)(results[i].cycles >> 24));
+    }
+}
+
+#endif /* BENCH */
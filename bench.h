@@ -0,0 +1,52 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+/*
+ * Cycle-count benchmarks of the hot paths, built with make BENCH=1.
+ *
+ * Timer 1 runs free at 32 MHz, one tick per CPU clock, and every call is
+ * timed on its own so a 16-bit difference never wraps. The cost of
+ * reading the timer is measured once and subtracted.
+ *
+ * The framebuffer benchmarks overwrite the framebuffer.
+ *
+ * CMD_BENCH protocol (host_script/matrix.py):
+ *   -> ACK, host sends BENCH_RX_BYTES bytes (timed uart_getc calls)
+ *   <- uart_printf output line, ACK, count, count x
+ *      (id u8, calls u16, total cycles u32), little endian
+ */
+#define BENCH_SPI_BYTE      0   /* DEV_SPI_WriteByte() */
+#define BENCH_UART_GETC     1   /* uart_getc() with a byte waiting */
+#define BENCH_UART_PRINTF   2   /* uart_printf() of a short line, TX bound */
+#define BENCH_CRC32_64      3   /* crc32_update() over 64 bytes; at ~350
+                                   cycles a byte 256 would wrap the timer */
+#define BENCH_ASSET_ROW     4   /* asset_row(), PackBits if there is one */
+#define BENCH_TEXT_ROW      5   /* text_row() */
+#define BENCH_COMPOSE_ROW   6   /* compose_row() */
+
+/* fb.h against plain C loops, BENCH_FB_LEN bytes of the framebuffer */
+#define BENCH_FILL_C        7
+#define BENCH_FILL_CPU      8   /* fb_cpu_fill() */
+#define BENCH_FILL_DMA      9   /* fb_dma_fill() */
+#define BENCH_COPY_C        10
+#define BENCH_COPY_CPU      11  /* fb_cpu_copy(), DPTR0/DPTR1 */
+#define BENCH_COPY_DMA      12  /* fb_dma_copy() */
+#define BENCH_CODE_C        13  /* from flash */
+#define BENCH_CODE_DMA      14  /* fb_copy_code() */
+#define BENCH_INVERT_C      15
+#define BENCH_INVERT_CPU    16  /* fb_invert() */
+#define BENCH_XOR_C         17
+#define BENCH_XOR_CPU       18  /* fb_xor() */
+#define BENCH_ROW_C         19  /* one 13-byte row, as frame_row() was */
+#define BENCH_ROW_FB        20  /* fb_copy() of one row, CPU path */
+#define BENCH_SPI_ROW       21  /* SPI_WriteBytes() of one row, inverted */
+#define BENCH_COUNT         22
+
+#define BENCH_RX_BYTES      16
+#define BENCH_FB_LEN        512 /* C loops stay under 65536 cycles */
+
+void bench_run(void);
+
+#endif /* BENCH_H */
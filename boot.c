@@ -0,0 +1,301 @@
+/*
+ * boot.c — serial bootloader, flash pages 0-1
+ *
+ * On reset it jumps straight to the application unless the image info
+ * page is missing or the application left BOOT_MAGIC in XRAM (see
+ * boot_enter()). Otherwise it serves BOOT_CMD_* over USART1 Alt.2 at the
+ * same 921600 baud as the application, so the host keeps its port open.
+ *
+ * Pages are received into XRAM, checked against the host's CRC32, erased
+ * and written by the flash controller fed from DMA channel 0, then read
+ * back and checked again. The host only sends pages whose CRC differs,
+ * so rebuilding and flashing a small change touches a few pages.
+ *
+ * The info page is erased before the first page of an image changes and
+ * written only once the whole image verified, its magic word last, so
+ * a flash cut short at any point leaves no bootable image behind.
+ *
+ * Build: make boot (see Makefile), application: make app
+ */
+
+#include <cc2530.h>
+#include <stdint.h>
+#include "boot.h"
+#include "crc32.h"
+
+/* -----------------------------------------------------------------------
+ * Interrupt vectors — the application owns them all, forward each one
+ * to the same vector in its table at BOOT_APP_BASE
+ * ----------------------------------------------------------------------- */
+#define BOOT_VECTOR(n, off) \
+    void boot_vector_##n(void) __interrupt(n) __naked \
+    { __asm ljmp BOOT_APP_BASE+off __endasm; }
+
+BOOT_VECTOR(0,  0x03)   /* RFERR */
+BOOT_VECTOR(1,  0x0B)   /* ADC   */
+BOOT_VECTOR(2,  0x13)   /* URX0  */
+BOOT_VECTOR(3,  0x1B)   /* URX1  */
+BOOT_VECTOR(4,  0x23)   /* ENC   */
+BOOT_VECTOR(5,  0x2B)   /* ST    */
+BOOT_VECTOR(6,  0x33)   /* P2INT */
+BOOT_VECTOR(7,  0x3B)   /* UTX0  */
+BOOT_VECTOR(8,  0x43)   /* DMA   */
+BOOT_VECTOR(9,  0x4B)   /* T1    */
+BOOT_VECTOR(10, 0x53)   /* T2    */
+BOOT_VECTOR(11, 0x5B)   /* T3    */
+BOOT_VECTOR(12, 0x63)   /* T4    */
+BOOT_VECTOR(13, 0x6B)   /* P0INT */
+BOOT_VECTOR(14, 0x73)   /* UTX1  */
+BOOT_VECTOR(15, 0x7B)   /* P1INT */
+BOOT_VECTOR(16, 0x83)   /* RF    */
+BOOT_VECTOR(17, 0x8B)   /* WDT   */
+
+#define BOOT_INFO   ((__code const boot_info_t *)BOOT_INFO_ADDR)
+
+/* The last page ends with the flash lock bits, never write it */
+#define BOOT_LAST_PAGE  (BOOT_FLASH_PAGES - 1)
+#define BOOT_APP_MAX    ((uint32_t)BOOT_LAST_PAGE * BOOT_PAGE_SIZE - BOOT_APP_BASE)
+
+/* -----------------------------------------------------------------------
+ * Runs from the SDCC startup code before RAM is initialised, so it may
+ * only look at flash and the absolute XRAM magic
+ * ----------------------------------------------------------------------- */
+unsigned char __sdcc_external_startup(void)
+{
+    if (BOOT_MAGIC_REG == BOOT_MAGIC) {
+        BOOT_MAGIC_REG = 0;                 /* one-shot */
+        return 0;
+    }
+    if (BOOT_INFO->magic == BOOT_INFO_MAGIC &&
+        BOOT_INFO->length && BOOT_INFO->length <= BOOT_APP_MAX)
+        __asm ljmp BOOT_APP_BASE __endasm;
+    return 0;
+}
+
+/* -----------------------------------------------------------------------
+ * UART — USART1 Alt.2, polled (same setup as uart.c)
+ * ----------------------------------------------------------------------- */
+static void boot_uart_init(void)
+{
+    PERCFG |= 0x02;
+    P1SEL  |= (1<<6) | (1<<7);
+    P1DIR  |= (1<<6);
+    P1DIR  &= ~(1<<7);
+    U1CSR   = 0x80;
+    U1UCR   = 0x02;
+    U1BAUD  = 216;
+    U1GCR   = 14;       /* 921600 @ 32MHz */
+    U1CSR  |= 0x40;
+}
+
+static void boot_putc(uint8_t b)
+{
+    U1DBUF = b;
+    while (!(U1CSR & 0x02));
+    U1CSR &= ~0x02;
+}
+
+static uint8_t boot_getc(void)
+{
+    while (!RX_BYTE);
+    return U1DBUF;
+}
+
+static uint32_t boot_get_u32(void)
+{
+    uint32_t v;
+    v  = boot_getc();
+    v |= (uint16_t)boot_getc() << 8;
+    v |= (uint32_t)boot_getc() << 16;
+    v |= (uint32_t)boot_getc() << 24;
+    return v;
+}
+
+static void boot_put_u32(uint32_t v)
+{
+    boot_putc((uint8_t)v);
+    boot_putc((uint8_t)(v >> 8));
+    boot_putc((uint8_t)(v >> 16));
+    boot_putc((uint8_t)(v >> 24));
+}
+
+/* -----------------------------------------------------------------------
+ * Flash
+ *
+ * Any flash address is read through the 0x8000-0xFFFF code window with
+ * FMAP selecting the 32 KB bank, so pages above 32 KB (banked builds)
+ * verify the same way. Writes are in 32-bit words: FADDR = addr / 4.
+ * ----------------------------------------------------------------------- */
+#define X_FWDATA  (0x7000 + 0xAF)   /* FWDATA as seen by the DMA */
+#define DMA_TRIG_FLASH  18
+
+static __xdata uint8_t     page_buf[BOOT_PAGE_SIZE];
+static __xdata uint8_t     dma_desc[8];
+static __xdata boot_info_t info_buf;
+static uint8_t             info_erased;
+
+static uint32_t flash_crc(uint32_t addr, uint32_t len)
+{
+    __code const uint8_t *p;
+    uint32_t crc = CRC32_INIT;
+
+    FMAP = (uint8_t)(addr >> 15);
+    p    = (__code const uint8_t *)(0x8000 | ((uint16_t)addr & 0x7FFF));
+    while (len--) {
+        crc = crc32_byte(crc, *p++);
+        if (!p) {                           /* ran off 0xFFFF, next bank */
+            FMAP++;
+            p = (__code const uint8_t *)0x8000;
+        }
+    }
+    FMAP = 1;                               /* reset value */
+    return CRC32_FINAL(crc);
+}
+
+static void flash_erase(uint8_t page)
+{
+    while (FCTL & 0x80);
+    FADDRH = page << 1;                     /* page * 2048 / 4 */
+    FADDRL = 0;
+    FCTL  |= 0x01;                          /* ERASE */
+    __asm nop __endasm;
+    while (FCTL & 0x80);                    /* BUSY */
+}
+
+static void flash_write(uint32_t addr, __xdata uint8_t *src, uint16_t len)
+{
+    /* DMA descriptor: src++ -> FWDATA, byte size, single transfers on
+     * the FLASH trigger, high priority */
+    dma_desc[0] = (uint16_t)src >> 8;
+    dma_desc[1] = (uint16_t)src;
+    dma_desc[2] = X_FWDATA >> 8;
+    dma_desc[3] = X_FWDATA & 0xFF;
+    dma_desc[4] = len >> 8;                 /* VLEN=0, LEN[12:8] */
+    dma_desc[5] = len;
+    dma_desc[6] = DMA_TRIG_FLASH;           /* WORDSIZE=0, TMODE=single */
+    dma_desc[7] = 0x42;                     /* SRCINC=1, DESTINC=0, prio high */
+
+    DMA0CFGH = (uint16_t)dma_desc >> 8;
+    DMA0CFGL = (uint16_t)dma_desc;
+
+    while (FCTL & 0x80);
+    FADDRH = (uint8_t)(addr >> 10);
+    FADDRL = (uint8_t)(addr >> 2);
+    DMAARM |= 0x01;
+    FCTL   |= 0x02;                         /* WRITE, pulls words via DMA */
+    while (FCTL & 0x80);
+}
+
+/* Invalidate the image before the first page of a new one is written */
+static void info_invalidate(void)
+{
+    if (!info_erased) {
+        flash_erase(BOOT_INFO_ADDR / BOOT_PAGE_SIZE);
+        info_erased = 1;
+    }
+}
+
+/* -----------------------------------------------------------------------
+ * Commands
+ * ----------------------------------------------------------------------- */
+static void cmd_write(void)
+{
+    uint8_t  page = boot_getc();
+    uint32_t addr = (uint32_t)page * BOOT_PAGE_SIZE;
+    uint32_t crc;
+    uint16_t i;
+
+    if (addr < BOOT_APP_BASE || page >= BOOT_LAST_PAGE) {
+        boot_putc(BOOT_NAK);
+        return;
+    }
+    boot_putc(BOOT_ACK);
+
+    for (i = 0; i < BOOT_PAGE_SIZE; i++)
+        page_buf[i] = boot_getc();
+    crc = boot_get_u32();
+
+    if (CRC32_FINAL(crc32_update(CRC32_INIT, page_buf, BOOT_PAGE_SIZE)) != crc) {
+        boot_putc(BOOT_NAK);                /* corrupted in transit */
+        return;
+    }
+
+    info_invalidate();
+    flash_erase(page);
+    flash_write(addr, page_buf, BOOT_PAGE_SIZE);
+
+    boot_putc(flash_crc(addr, BOOT_PAGE_SIZE) == crc ? BOOT_ACK : BOOT_NAK);
+}
+
+static void cmd_finish(void)
+{
+    uint32_t len = boot_get_u32();
+    uint32_t crc = boot_get_u32();
+
+    if (len == 0 || len > BOOT_APP_MAX ||
+        flash_crc(BOOT_APP_BASE, len) != crc) {
+        boot_putc(BOOT_NAK);
+        return;
+    }
+
+    /* Length and CRC first, then the magic: a reset in between leaves
+     * the page without it */
+    info_invalidate();
+    info_buf.magic  = BOOT_INFO_MAGIC;
+    info_buf.length = len;
+    info_buf.crc    = crc;
+    flash_write(BOOT_INFO_ADDR + 4, (__xdata uint8_t *)&info_buf.length,
+                sizeof(boot_info_t) - 4);
+    flash_write(BOOT_INFO_ADDR, (__xdata uint8_t *)&info_buf.magic, 4);
+    info_erased = 0;
+
+    boot_putc(BOOT_INFO->magic == BOOT_INFO_MAGIC ? BOOT_ACK : BOOT_NAK);
+}
+
+void main(void)
+{
+    uint8_t page;
+
+    CLKCONCMD = 0x00;                       /* 32 MHz XOSC */
+    while (CLKCONSTA & 0x40);
+    boot_uart_init();
+
+    while (1)
+    {
+        switch (boot_getc())
+        {
+        case BOOT_CMD_INFO:
+            boot_putc(BOOT_ACK);
+            boot_putc(BOOT_VERSION);
+            boot_putc(BOOT_APP_BASE & 0xFF);
+            boot_putc(BOOT_APP_BASE >> 8);
+            boot_putc(BOOT_FLASH_PAGES);
+            boot_putc(BOOT_INFO->magic == BOOT_INFO_MAGIC);
+            break;
+
+        case BOOT_CMD_CRC:
+            page = boot_getc();
+            boot_putc(BOOT_ACK);
+            boot_put_u32(flash_crc((uint32_t)page * BOOT_PAGE_SIZE,
+                                   BOOT_PAGE_SIZE));
+            break;
+
+        case BOOT_CMD_WRITE:
+            cmd_write();
+            break;
+
+        case BOOT_CMD_FINISH:
+            cmd_finish();
+            break;
+
+        case BOOT_CMD_GO:
+            boot_putc(BOOT_ACK);
+            boot_reset();                   /* magic is gone, boots the app */
+            break;
+
+        default:
+            boot_putc(BOOT_NAK);
+            break;
+        }
+    }
+}
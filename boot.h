@@ -0,0 +1,63 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <cc2530.h>
+#include <stdint.h>
+
+/*
+ * Serial bootloader flash layout (2 KB pages)
+ *
+ *   0x0000 - 0x0FFF  bootloader (boot.c), forwards interrupt vectors
+ *   0x1000 - 0x17FF  image info page, written once an image verified
+ *   0x1800 - ...     application, linked with --code-loc BOOT_APP_BASE
+ *
+ * Plain numbers on purpose: BOOT_APP_BASE is also used in __asm blocks.
+ */
+#define BOOT_PAGE_SIZE   2048
+#define BOOT_INFO_ADDR   0x1000
+#define BOOT_APP_BASE    0x1800
+#define BOOT_FLASH_PAGES 128          /* CC2530F256 */
+
+#define BOOT_INFO_MAGIC  0x544F4F42UL /* "BOOT" */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t length;                  /* bytes from BOOT_APP_BASE */
+    uint32_t crc;                     /* CRC32 over those bytes */
+} boot_info_t;
+
+/*
+ * The application asks for the bootloader by leaving BOOT_MAGIC in XRAM
+ * and resetting through the watchdog. The address sits below the 256
+ * bytes at 0x1F00 that alias IRAM (and the stack).
+ */
+#define BOOT_MAGIC_ADDR  0x1EFC
+#define BOOT_MAGIC       0xB007
+#define BOOT_MAGIC_REG   (*(volatile __xdata uint16_t *)BOOT_MAGIC_ADDR)
+
+/* Bootloader protocol, see host_script/flash.py */
+#define BOOT_CMD_INFO    0x49   /* 'I' -> ACK, version, app base u16, pages, info valid */
+#define BOOT_CMD_CRC     0x50   /* 'P' page -> ACK, CRC32 of the page */
+#define BOOT_CMD_WRITE   0x57   /* 'W' page -> ACK, 2048 bytes + CRC32 -> ACK/NAK */
+#define BOOT_CMD_FINISH  0x46   /* 'F' length u32, CRC32 -> ACK/NAK */
+#define BOOT_CMD_GO      0x47   /* 'G' -> ACK, reset into the application */
+
+#define BOOT_ACK         0x06
+#define BOOT_NAK         0x15
+#define BOOT_VERSION     1
+
+/* Reset through the watchdog at its shortest interval (~2 ms) */
+static void boot_reset(void)
+{
+    WDCTL = 0x08 | 0x03;   /* EN, INT=11 */
+    while (1);
+}
+
+/* Called by the application: reset into the bootloader */
+static void boot_enter(void)
+{
+    BOOT_MAGIC_REG = BOOT_MAGIC;
+    boot_reset();
+}
+
+#endif /* BOOT_H */
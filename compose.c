@@ -0,0 +1,90 @@
+#include <stdint.h>
+#include "compose.h"
+#include "GxGDEW0213Z16.h"
+#include "assets.h"
+
+__xdata uint8_t compose_pool[COMPOSE_POOL_SIZE];
+
+static uint8_t bg;                    /* COMPOSE_BG_WHITE or COMPOSE_BG(id) */
+static __xdata compose_overlay_t overlays[COMPOSE_MAX_OVERLAYS];
+static HOT_VAR uint8_t overlay_count;
+static uint16_t pool_used;
+
+uint8_t compose_set_background(uint8_t index)
+{
+    if (index != COMPOSE_BG_WHITE &&
+        (index > ASSET_COUNT || assets[index - 1].kind != ASSET_KIND_FRAME))
+        return 0;
+    bg = index;
+    return 1;
+}
+
+void compose_clear_overlays(void)
+{
+    overlay_count = 0;
+    pool_used     = 0;
+}
+
+/* -----------------------------------------------------------------------
+ * Reserve an overlay, returns where its w * h bytes go or 0 if it does
+ * not fit on the panel, in the pool or in the overlay table
+ * ----------------------------------------------------------------------- */
+__xdata uint8_t *compose_add_overlay(uint8_t op, uint8_t col, uint8_t w,
+                                     uint8_t y, uint8_t h)
+{
+    __xdata compose_overlay_t *o;
+    uint16_t size = (uint16_t)w * h;
+
+    if (overlay_count >= COMPOSE_MAX_OVERLAYS || op >= COMPOSE_OP_COUNT ||
+        !w || !h || (uint16_t)col + w > EPD_ROW_BYTES ||
+        (uint16_t)y + h > EPD_HEIGHT || size > COMPOSE_POOL_SIZE - pool_used)
+        return 0;
+
+    o = &overlays[overlay_count++];
+    o->op     = op;
+    o->col    = col;
+    o->w      = w;
+    o->y      = y;
+    o->h      = h;
+    o->offset = pool_used;
+    pool_used += size;
+    return compose_pool + o->offset;
+}
+
+/* -----------------------------------------------------------------------
+ * Render panel row y into epd_row: background, then overlays in order.
+ * Backgrounds may be compressed, so rows must come in order from 0.
+ * ----------------------------------------------------------------------- */
+void compose_row(uint8_t y) NONBANKED
+{
+    __xdata compose_overlay_t *o;
+    __xdata uint8_t          *src;
+    __xdata uint8_t          *dst;
+    uint8_t i, n;
+
+    if (bg != COMPOSE_BG_WHITE) {
+        if (y == 0)
+            asset_open(bg - 1);
+        asset_row(y);
+    } else {
+        for (i = 0; i < EPD_ROW_BYTES; i++)
+            epd_row[i] = 0xFF;
+    }
+
+    for (n = 0; n < overlay_count; n++) {
+        o = &overlays[n];
+        if (y < o->y || y - o->y >= o->h)
+            continue;
+
+        src = compose_pool + o->offset + (uint16_t)(y - o->y) * o->w;
+        dst = epd_row + o->col;
+        i   = o->w;
+
+        switch (o->op) {
+        case COMPOSE_REPLACE: while (i--) *dst++  = *src++; break;
+        case COMPOSE_OR:      while (i--) *dst++ |= *src++; break;
+        case COMPOSE_AND:     while (i--) *dst++ &= *src++; break;
+        case COMPOSE_XOR:     while (i--) *dst++ ^= *src++; break;
+        }
+    }
+}
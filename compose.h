@@ -0,0 +1,45 @@
+#ifndef COMPOSE_H
+#define COMPOSE_H
+
+#include <stdint.h>
+#include "bank.h"
+
+/*
+ * Frame composition at scan-out: a background frame in flash with small
+ * overlay rectangles from RAM applied on top, row by row while the frame
+ * is sent (see EPD_SendRows()).
+ *
+ * Overlays use framebuffer coordinates: byte column 0-12 (8 pixels
+ * each) and panel row 0-211, data in framebuffer polarity (1 = white),
+ * w bytes per row.
+ */
+#define COMPOSE_MAX_OVERLAYS  4
+#define COMPOSE_POOL_SIZE     1024
+
+/* Backgrounds: white or a frame asset (see assets/assets.list) */
+#define COMPOSE_BG_WHITE      0
+#define COMPOSE_BG(asset)     ((asset) + 1)
+
+/* Overlay ops, applied to the background byte */
+#define COMPOSE_REPLACE       0
+#define COMPOSE_OR            1       /* draws white pixels only */
+#define COMPOSE_AND           2       /* draws black pixels only */
+#define COMPOSE_XOR           3       /* inverts where the overlay is 1 */
+#define COMPOSE_OP_COUNT      4
+
+typedef struct {
+    uint8_t  op;
+    uint8_t  col, w;                  /* byte column, width in bytes */
+    uint8_t  y, h;                    /* first panel row, rows */
+    uint16_t offset;                  /* data in compose_pool */
+} compose_overlay_t;
+
+extern __xdata uint8_t compose_pool[COMPOSE_POOL_SIZE];
+
+uint8_t compose_set_background(uint8_t index);
+void    compose_clear_overlays(void);
+__xdata uint8_t *compose_add_overlay(uint8_t op, uint8_t col, uint8_t w,
+                                     uint8_t y, uint8_t h);
+void    compose_row(uint8_t y) NONBANKED;   /* epd_row_fn */
+
+#endif /* COMPOSE_H */
@@ -0,0 +1,31 @@
+/* -----------------------------------------------------------------------
+ * CRC-32, nibble table
+ *
+ * Two lookups per byte into a 64-byte __code table instead of the usual
+ * 1 KB byte table; ~2756 bytes hash in a few tens of ms @ 32MHz.
+ * ----------------------------------------------------------------------- */
+#include <stdint.h>
+#include "crc32.h"
+
+static __code const uint32_t crc_tab[16] = {
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+    0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+    0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+};
+
+uint32_t crc32_byte(uint32_t crc, uint8_t b) NONBANKED
+{
+    crc ^= b;
+    crc = (crc >> 4) ^ crc_tab[(uint8_t)crc & 0x0F];
+    crc = (crc >> 4) ^ crc_tab[(uint8_t)crc & 0x0F];
+    return crc;
+}
+
+uint32_t crc32_update(uint32_t crc, __xdata const uint8_t *buf,
+                      uint16_t len) NONBANKED
+{
+    while (len--)
+        crc = crc32_byte(crc, *buf++);
+    return crc;
+}
@@ -0,0 +1,22 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+#include "bank.h"
+
+/*
+ * CRC-32 (IEEE 802.3, reflected 0xEDB88320), same result as Python's
+ * zlib.crc32() so the host can compare frame hashes directly.
+ *
+ *   crc = CRC32_INIT;
+ *   crc = crc32_update(crc, buf, len);
+ *   crc = CRC32_FINAL(crc);
+ */
+#define CRC32_INIT        0xFFFFFFFFUL
+#define CRC32_FINAL(crc)  (~(crc))
+
+uint32_t crc32_byte(uint32_t crc, uint8_t b) NONBANKED;
+uint32_t crc32_update(uint32_t crc, __xdata const uint8_t *buf,
+                      uint16_t len) NONBANKED;
+
+#endif /* CRC32_H */
@@ -0,0 +1,34 @@
+#ifndef DMA_H
+#define DMA_H
+
+#include <stdint.h>
+
+/*
+ * DMA descriptors (CC2530 user's guide, section 8)
+ *
+ * Channel 0 has its own descriptor pointer (DMA0CFGH/L). Channels 1-4
+ * take theirs from an array of four at DMA1CFGH/L.
+ *
+ *   channel 0  fb.c, framebuffer fill/copy
+ *   channel 1  radio.c, RX FIFO to RAM
+ *   channel 2  radio.c, RAM to TX FIFO
+ */
+typedef struct {
+    uint8_t srch, srcl;
+    uint8_t dsth, dstl;
+    uint8_t lenh;                 /* VLEN [7:5], LEN [12:8] */
+    uint8_t lenl;
+    uint8_t trig;                 /* WORDSIZE, TMODE, TRIG */
+    uint8_t mode;                 /* SRCINC, DESTINC, IRQMASK, M8, PRIORITY */
+} dma_desc_t;
+
+#define DMA_VLEN_FIRST  0x20      /* lenh: first byte + 1 bytes, LEN is max */
+#define DMA_BLOCK       0x20      /* trig: TMODE block, TRIG 0: DMAREQ */
+#define DMA_SRC_INC     0x40
+#define DMA_DST_INC     0x10
+#define DMA_IRQ         0x08
+#define DMA_PRI_HIGH    0x02
+
+#define DMA_CH(n)       (1 << (n))     /* DMAARM, DMAREQ, DMAIRQ */
+
+#endif /* DMA_H */
@@ -0,0 +1,22 @@
+#include <cc2530.h>
+#include <stdint.h>
+#include "epd_busy.h"
+
+void EPD_Busy_Init(void)
+{
+    P1SEL &= ~(1<<2);   /* GPIO, not peripheral */
+    P1DIR &= ~(1<<2);   /* input */
+
+    PICTL &= ~(1<<1);   /* P1_0-P1_3: rising edge */
+    P1IFG  = 0;
+    P1IF   = 0;
+    P1IEN |=  (1<<2);
+    IEN2  |=  (1<<4);   /* P1IE */
+}
+
+/* returns 1 if busy, 0 if ready */
+uint8_t EPD_Busy(void)
+{
+    //return P1_2 ? 1 : 0;
+    return P1_2 ? 0 : 1;
+}
@@ -7,19 +7,12 @@
 /*
  * EINK_BUSY → P1_2
  * UC8151/IL0373: HIGH = busy, LOW = ready
+ *
+ * The rising edge (ready) raises the port 1 interrupt, which posts
+ * EV_EPD_BUSY (sched.c). Code in epd_busy.c.
  */
 
-static void EPD_Busy_Init(void)
-{
-    P1SEL &= ~(1<<2);   /* GPIO, not peripheral */
-    P1DIR &= ~(1<<2);   /* input */
-}
-
-/* returns 1 if busy, 0 if ready */
-static uint8_t EPD_Busy(void)
-{
-    //return P1_2 ? 1 : 0;
-    return P1_2 ? 0 : 1;
-}
+void EPD_Busy_Init(void);
+uint8_t EPD_Busy(void);    /* 1 if busy, 0 if ready */
 
 #endif /* EPD_BUSY_H */
\ No newline at end of file
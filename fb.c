@@ -0,0 +1,330 @@
+/* -----------------------------------------------------------------------
+ * Framebuffer primitives, see fb.h
+ *
+ * The CPU loops take the destination in DPTR (SDCC's first argument)
+ * and the rest in __data variables, so they work in every memory model.
+ * Loop counts are split for djnz: r6 = low byte, r7 = high byte, plus
+ * one if the low byte is not zero.
+ * ----------------------------------------------------------------------- */
+#include <cc2530.h>
+#include <stdint.h>
+#include "fb.h"
+#include "dma.h"
+#include "GxGDEW0213Z16.h"
+
+#ifndef SIM
+static __data uint16_t fb_len;
+static __data uint16_t fb_src;
+static __data uint8_t  fb_val;
+
+/* -----------------------------------------------------------------------
+ * CPU loops
+ * ----------------------------------------------------------------------- */
+static void cpu_fill(__xdata uint8_t *dst) NONBANKED __naked
+{
+    (void)dst;
+    __asm
+        mov     a, _fb_len
+        mov     r6, a
+        mov     r7, (_fb_len + 1)
+        jz      00001$
+        inc     r7
+00001$:
+        mov     a, r7
+        jz      00003$
+        mov     a, _fb_val
+00002$:
+        movx    @dptr, a
+        inc     dptr
+        djnz    r6, 00002$
+        djnz    r7, 00002$
+00003$:
+        ret
+    __endasm;
+}
+
+/* DPTR0 = dst, DPTR1 = src; inc/dec DPS switches between them */
+static void cpu_copy(__xdata uint8_t *dst) NONBANKED __naked
+{
+    (void)dst;
+    __asm
+        mov     _DPL1, _fb_src
+        mov     _DPH1, (_fb_src + 1)
+        mov     a, _fb_len
+        mov     r6, a
+        mov     r7, (_fb_len + 1)
+        jz      00001$
+        inc     r7
+00001$:
+        mov     a, r7
+        jz      00003$
+00002$:
+        inc     _DPS
+        movx    a, @dptr
+        inc     dptr
+        dec     _DPS
+        movx    @dptr, a
+        inc     dptr
+        djnz    r6, 00002$
+        djnz    r7, 00002$
+00003$:
+        ret
+    __endasm;
+}
+
+static void cpu_copy_code(__xdata uint8_t *dst) NONBANKED __naked
+{
+    (void)dst;
+    __asm
+        mov     _DPL1, _fb_src
+        mov     _DPH1, (_fb_src + 1)
+        mov     a, _fb_len
+        mov     r6, a
+        mov     r7, (_fb_len + 1)
+        jz      00001$
+        inc     r7
+00001$:
+        mov     a, r7
+        jz      00003$
+00002$:
+        inc     _DPS
+        clr     a
+        movc    a, @a+dptr
+        inc     dptr
+        dec     _DPS
+        movx    @dptr, a
+        inc     dptr
+        djnz    r6, 00002$
+        djnz    r7, 00002$
+00003$:
+        ret
+    __endasm;
+}
+
+static void cpu_invert(__xdata uint8_t *dst) NONBANKED __naked
+{
+    (void)dst;
+    __asm
+        mov     a, _fb_len
+        mov     r6, a
+        mov     r7, (_fb_len + 1)
+        jz      00001$
+        inc     r7
+00001$:
+        mov     a, r7
+        jz      00003$
+00002$:
+        movx    a, @dptr
+        cpl     a
+        movx    @dptr, a
+        inc     dptr
+        djnz    r6, 00002$
+        djnz    r7, 00002$
+00003$:
+        ret
+    __endasm;
+}
+
+static void cpu_xor(__xdata uint8_t *dst) NONBANKED __naked
+{
+    (void)dst;
+    __asm
+        mov     _DPL1, _fb_src
+        mov     _DPH1, (_fb_src + 1)
+        mov     a, _fb_len
+        mov     r6, a
+        mov     r7, (_fb_len + 1)
+        jz      00001$
+        inc     r7
+00001$:
+        mov     a, r7
+        jz      00003$
+00002$:
+        inc     _DPS
+        movx    a, @dptr
+        inc     dptr
+        dec     _DPS
+        mov     r5, a
+        movx    a, @dptr
+        xrl     a, r5
+        movx    @dptr, a
+        inc     dptr
+        djnz    r6, 00002$
+        djnz    r7, 00002$
+00003$:
+        ret
+    __endasm;
+}
+
+void fb_cpu_fill(__xdata uint8_t *dst, uint8_t value, uint16_t len) NONBANKED
+{
+    fb_val = value;
+    fb_len = len;
+    cpu_fill(dst);
+}
+
+void fb_cpu_copy(__xdata uint8_t *dst, __xdata const uint8_t *src,
+                 uint16_t len) NONBANKED
+{
+    fb_src = (uint16_t)src;
+    fb_len = len;
+    cpu_copy(dst);
+}
+
+/* -----------------------------------------------------------------------
+ * DMA channel 0
+ * ----------------------------------------------------------------------- */
+static __xdata dma_desc_t dma0;
+static __xdata uint8_t    dma_fill;
+
+static void dma_run(uint16_t src, __xdata uint8_t *dst, uint16_t len,
+                    uint8_t mode) NONBANKED
+{
+    dma0.srch = src >> 8;
+    dma0.srcl = (uint8_t)src;
+    dma0.dsth = (uint16_t)dst >> 8;
+    dma0.dstl = (uint8_t)(uint16_t)dst;
+    dma0.lenh = (len >> 8) & 0x1F;
+    dma0.lenl = (uint8_t)len;
+    dma0.trig = DMA_BLOCK;
+    dma0.mode = mode | DMA_DST_INC | DMA_PRI_HIGH;   /* the CPU waits */
+
+    DMA0CFGH = (uint16_t)&dma0 >> 8;
+    DMA0CFGL = (uint8_t)(uint16_t)&dma0;
+    DMAARM   = DMA_CH(0);
+    __asm                         ; 9 clocks to load the descriptor
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+    __endasm;
+    DMAREQ = DMA_CH(0);
+    while (DMAARM & DMA_CH(0));   /* cleared when the block is done */
+}
+
+void fb_dma_fill(__xdata uint8_t *dst, uint8_t value, uint16_t len) NONBANKED
+{
+    dma_fill = value;
+    dma_run((uint16_t)&dma_fill, dst, len, 0);
+}
+
+void fb_dma_copy(__xdata uint8_t *dst, uint16_t src, uint16_t len) NONBANKED
+{
+    dma_run(src, dst, len, DMA_SRC_INC);
+}
+
+/* -----------------------------------------------------------------------
+ * API
+ * ----------------------------------------------------------------------- */
+void fb_fill(__xdata uint8_t *dst, uint8_t value, uint16_t len) NONBANKED
+{
+    if (len < FB_DMA_MIN)
+        fb_cpu_fill(dst, value, len);
+    else
+        fb_dma_fill(dst, value, len);
+}
+
+void fb_copy(__xdata uint8_t *dst, __xdata const uint8_t *src,
+             uint16_t len) NONBANKED
+{
+    if (len < FB_DMA_MIN)
+        fb_cpu_copy(dst, src, len);
+    else
+        fb_dma_copy(dst, (uint16_t)src, len);
+}
+
+/* XBANK 0 shows flash 0x0000-0x7FFF at XDATA 0x8000 */
+void fb_copy_code(__xdata uint8_t *dst, __code const uint8_t *src,
+                  uint16_t len) NONBANKED
+{
+    uint8_t memctr;
+
+    if (len < FB_DMA_MIN) {
+        fb_src = (uint16_t)src;
+        fb_len = len;
+        cpu_copy_code(dst);
+        return;
+    }
+    memctr = MEMCTR;
+    MEMCTR = memctr & ~0x07;
+    fb_dma_copy(dst, 0x8000 | (uint16_t)src, len);
+    MEMCTR = memctr;
+}
+
+void fb_invert(__xdata uint8_t *dst, uint16_t len) NONBANKED
+{
+    fb_len = len;
+    cpu_invert(dst);
+}
+
+void fb_xor(__xdata uint8_t *dst, __xdata const uint8_t *src,
+            uint16_t len) NONBANKED
+{
+    fb_src = (uint16_t)src;
+    fb_len = len;
+    cpu_xor(dst);
+}
+
+#else /* SIM */
+/* -----------------------------------------------------------------------
+ * Host build (make sim): plain loops, there is no DMA or DPTR1
+ * ----------------------------------------------------------------------- */
+void fb_fill(__xdata uint8_t *dst, uint8_t value, uint16_t len) NONBANKED
+{
+    while (len--)
+        *dst++ = value;
+}
+
+void fb_copy(__xdata uint8_t *dst, __xdata const uint8_t *src,
+             uint16_t len) NONBANKED
+{
+    while (len--)
+        *dst++ = *src++;
+}
+
+void fb_copy_code(__xdata uint8_t *dst, __code const uint8_t *src,
+                  uint16_t len) NONBANKED
+{
+    while (len--)
+        *dst++ = *src++;
+}
+
+void fb_invert(__xdata uint8_t *dst, uint16_t len) NONBANKED
+{
+    while (len--) {
+        *dst = ~*dst;
+        dst++;
+    }
+}
+
+void fb_xor(__xdata uint8_t *dst, __xdata const uint8_t *src,
+            uint16_t len) NONBANKED
+{
+    while (len--)
+        *dst++ ^= *src++;
+}
+#endif /* SIM */
+
+void fb_invert_rect(__xdata uint8_t *frame, uint8_t col, uint8_t w,
+                    uint8_t y, uint8_t h)
+{
+    __xdata uint8_t *row;
+
+    if (col >= EPD_ROW_BYTES || y >= EPD_HEIGHT)
+        return;
+    if (w > EPD_ROW_BYTES - col)
+        w = EPD_ROW_BYTES - col;
+    if (h > EPD_HEIGHT - y)
+        h = EPD_HEIGHT - y;
+
+    row = frame + (uint16_t)y * EPD_ROW_BYTES + col;
+    while (h--) {
+        fb_invert(row, w);
+        row += EPD_ROW_BYTES;
+    }
+}
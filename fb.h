@@ -0,0 +1,48 @@
+#ifndef FB_H
+#define FB_H
+
+#include <stdint.h>
+#include "bank.h"
+
+/*
+ * Framebuffer memory primitives
+ *
+ * fb_fill/fb_copy/fb_copy_code use DMA channel 0, block transfers with
+ * a software trigger; the CPU waits for them. Below FB_DMA_MIN bytes the
+ * descriptor setup costs more than it saves and the CPU routines run
+ * instead: hand-written loops using the CC2530's second data pointer
+ * (DPTR1, selected by DPS), so a copy does not reload DPTR per byte.
+ * The DMA can't XOR, so invert and XOR are CPU only.
+ *
+ * An ISR that uses DPTR must save DPS and clear it first (see
+ * uart_rx_isr()): it may interrupt a loop while DPTR1 is selected.
+ *
+ * fb_copy_code reads flash through the XDATA window at 0x8000 (MEMCTR
+ * XBANK 0), so its source must be in the common area, see bank.h.
+ *
+ * Cycle counts against plain C loops: make BENCH=1, bench.h.
+ */
+#define FB_DMA_MIN  16
+
+void fb_fill(__xdata uint8_t *dst, uint8_t value, uint16_t len) NONBANKED;
+void fb_copy(__xdata uint8_t *dst, __xdata const uint8_t *src,
+             uint16_t len) NONBANKED;
+void fb_copy_code(__xdata uint8_t *dst, __code const uint8_t *src,
+                  uint16_t len) NONBANKED;
+void fb_invert(__xdata uint8_t *dst, uint16_t len) NONBANKED;
+void fb_xor(__xdata uint8_t *dst, __xdata const uint8_t *src,
+            uint16_t len) NONBANKED;
+
+/* Invert w bytes x h rows of a 13-byte-per-row frame from byte column
+ * col, row y, clipped to the frame */
+void fb_invert_rect(__xdata uint8_t *frame, uint8_t col, uint8_t w,
+                    uint8_t y, uint8_t h);
+
+/* The two back ends, for the benchmarks */
+void fb_dma_fill(__xdata uint8_t *dst, uint8_t value, uint16_t len) NONBANKED;
+void fb_dma_copy(__xdata uint8_t *dst, uint16_t src, uint16_t len) NONBANKED;
+void fb_cpu_fill(__xdata uint8_t *dst, uint8_t value, uint16_t len) NONBANKED;
+void fb_cpu_copy(__xdata uint8_t *dst, __xdata const uint8_t *src,
+                 uint16_t len) NONBANKED;
+
+#endif /* FB_H */
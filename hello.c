@@ -1,220 +0,0 @@
-// generated by png2c.scm. sorry about the mess.
-#include <stdint.h>
-#include "hello.h"
-#include <cc2530.h>
-
-__xdata const uint8_t test1[BUFFER_SIZE] = {
-  0x00,0x00,0x2a,0x8b,0x5b,0x69,0x6d,0xb6,0xb5,0xad,0x55,0x55,0x55
-,0x52,0xaa,0x95,0x35,0x6a,0x85,0xb5,0x5a,0xd6,0xb5,0xb6,0xdb,0x6d
-,0x00,0x00,0x54,0x56,0xad,0x56,0xab,0x6b,0x5a,0xd6,0xda,0xaa,0xb6
-,0x2a,0x4a,0x29,0x5a,0xd4,0x2a,0xd5,0xaa,0xab,0x5a,0xab,0x55,0x55
-,0x00,0x10,0xa2,0xab,0x52,0xad,0x5a,0xad,0x6d,0x55,0x55,0x6d,0xaa
-,0x52,0x84,0x52,0xd5,0x50,0xb5,0xad,0x55,0xaa,0xaa,0xaa,0xaa,0xad
-,0x00,0x21,0x4b,0x5a,0x86,0xd6,0xb5,0xb6,0xb5,0x6d,0xb5,0x55,0x6a
-,0x4a,0x88,0x95,0x55,0x25,0x55,0x56,0xd5,0x56,0xb5,0x56,0xdb,0x55
-,0x00,0x20,0x2a,0xac,0x95,0xb5,0xaa,0xaa,0xda,0xd6,0xab,0x55,0x5a
-,0x29,0x05,0x55,0x68,0x2d,0x56,0xaa,0xb7,0x55,0x55,0x75,0x56,0xab
-,0x00,0x50,0x5b,0x52,0xb5,0xaa,0x56,0xd9,0x6b,0x6a,0xaa,0xb5,0x6d
-,0x54,0x02,0xaa,0xa0,0xaa,0xb5,0x6b,0x56,0xad,0xad,0xad,0x55,0xaa
-,0x01,0x21,0x55,0x95,0x56,0xd5,0x5a,0xab,0x55,0x56,0xb5,0xad,0x55
-,0x48,0x0a,0xda,0x82,0xdb,0x52,0xab,0x6c,0xb6,0xb5,0x56,0xb5,0x6d
-,0x02,0x85,0x56,0x25,0x6a,0x8b,0x6d,0x55,0x5a,0xd6,0xda,0xab,0x56
-,0x50,0x2b,0x69,0x0e,0xad,0x2d,0xb5,0xb3,0xab,0x5a,0xaa,0xb5,0xab
-,0x04,0x15,0x58,0x55,0x54,0x55,0x56,0xac,0xd5,0x6b,0x6c,0xd6,0xb5
-,0x21,0x55,0xa5,0x2a,0xe9,0x5a,0xaa,0xd6,0xba,0xaa,0xb6,0xaa,0x95
-,0x08,0xad,0x68,0x5b,0x52,0xad,0xdb,0x55,0x56,0xdb,0x54,0xb5,0xda
-,0x42,0x57,0x42,0xaa,0xa1,0x6a,0xad,0x56,0xd5,0x55,0x6a,0xad,0x4d
-,0x12,0xaa,0xa0,0xb5,0x4e,0xb6,0xd5,0xab,0x5b,0x6d,0xac,0xd5,0x56
-,0x4a,0xb6,0x8a,0xd6,0x0a,0xdb,0x6d,0x5a,0xad,0xaa,0xb6,0xad,0x8b
-,0x09,0xaa,0x22,0xa9,0x55,0x55,0x56,0xad,0xb5,0x5b,0x54,0xb6,0xca
-,0x52,0xdd,0x0a,0xd8,0x2e,0xed,0xb5,0x75,0x55,0x6d,0x6a,0xd5,0x4d
-,0x2b,0x6a,0x45,0x65,0x55,0x56,0xaa,0xab,0x6d,0xaa,0xad,0x55,0x45
-,0x45,0xb4,0x16,0x90,0xb6,0xf5,0x6b,0x5c,0xb6,0xb5,0xb4,0xb6,0xa6
-,0x0e,0xd2,0x95,0x85,0x5b,0x56,0xb5,0xab,0x55,0x56,0xd5,0x5b,0x4b
-,0x4b,0x70,0x2a,0x52,0xeb,0x55,0xca,0xd5,0xb6,0xda,0xa9,0xad,0x45
-,0x1a,0xc9,0x2d,0x05,0x55,0xb6,0xad,0x75,0x5b,0x6b,0x75,0x6a,0xd5
-,0x2f,0x60,0x54,0x4e,0xde,0xca,0x96,0xaa,0xd5,0x5a,0xa9,0x56,0x82
-,0x2a,0xca,0x69,0x15,0x6b,0x6d,0xab,0x57,0x6a,0xd6,0xd9,0xbb,0x53
-,0x3b,0x40,0xa0,0x5b,0xba,0x96,0x35,0x9a,0xb7,0x6b,0x69,0x55,0x45
-,0x56,0x92,0xca,0x6d,0x56,0xbb,0x5d,0x6a,0xda,0xb5,0x55,0x6d,0x92
-,0x7b,0x01,0x00,0xaa,0xfb,0x54,0xab,0x2d,0x55,0xad,0xb1,0xad,0x43
-,0xad,0x52,0xa9,0x6d,0xaa,0xb4,0xec,0xd7,0x6e,0xb6,0xd5,0x56,0x91
-,0x56,0x02,0x03,0x56,0xd5,0x5d,0x55,0x6a,0xb5,0x55,0x51,0x7b,0x49
-,0xba,0x49,0x25,0xbb,0x6d,0xe9,0xb9,0x5d,0xd5,0xdd,0xb2,0xad,0x02
-,0x54,0x04,0x0b,0x55,0xaa,0xaa,0xd5,0xaa,0xae,0xaa,0xd2,0xd5,0xa9
-,0xb5,0x21,0x4d,0xee,0xad,0x53,0x52,0xed,0xb5,0x77,0x53,0x5d,0x00
-,0xa8,0x08,0x16,0xbb,0xb5,0xb5,0xa7,0x56,0xdb,0xaa,0xa5,0x6a,0x95
-,0x69,0x42,0x5b,0xd6,0x55,0x4a,0xd5,0xbb,0x6c,0xbd,0xd2,0xbd,0x20
-,0xa4,0x10,0x36,0xfb,0x6b,0xef,0x4e,0xd5,0x57,0x56,0xa3,0x56,0x8a
-,0xd0,0x85,0x5d,0xac,0xb5,0x15,0x55,0x5b,0xb5,0xda,0xd2,0xda,0x40
-,0x52,0x10,0xee,0xdb,0xdb,0xd5,0x1e,0xed,0x5a,0xb5,0x45,0x6d,0x2a
-,0xa0,0x82,0xb5,0xb5,0x6d,0x1b,0x6b,0x56,0xed,0x5e,0xd3,0xb6,0x40
-,0xc8,0x29,0x5e,0xeb,0xae,0xad,0x35,0xbb,0x57,0xeb,0x45,0x5a,0x52
-,0x42,0x02,0xb5,0xb5,0xd7,0x74,0x5e,0xd5,0xba,0x5a,0xa2,0xea,0x44
-,0x90,0x95,0x57,0x6e,0xba,0x5d,0x6a,0xb6,0xd5,0xed,0x8b,0x5d,0x31
-,0x44,0x05,0xb5,0xab,0x2e,0xb4,0xbb,0x5b,0x6e,0xb6,0xa5,0x6a,0x98
-,0x91,0x4a,0xae,0x9d,0x35,0x69,0xed,0xed,0xb5,0xda,0x8b,0x74,0x2a
-,0x00,0x15,0x5a,0xaa,0x6c,0xb5,0x56,0xb6,0xaa,0xab,0x45,0xaa,0xa8
-,0xa4,0x9b,0x6b,0x5c,0xba,0xe9,0xfb,0xaa,0xde,0xf5,0x26,0xd9,0x3d
-,0x00,0x2a,0xb4,0x64,0xd5,0x63,0x5d,0xfb,0x6b,0x5e,0x8a,0xb4,0xaa
-,0x4a,0xaa,0xda,0xb0,0xb9,0xab,0xb6,0xae,0xb5,0xeb,0x26,0xe9,0x5c
-,0x00,0x55,0x55,0x54,0xd2,0xc5,0x6f,0xdb,0xdd,0x55,0x15,0xb4,0x6a
-,0x52,0xad,0xaa,0xa1,0x53,0x57,0xda,0xb6,0xd7,0xda,0x8a,0xd2,0xb7
-,0x01,0x55,0x52,0xc9,0xb2,0x8a,0xbd,0xfd,0xba,0xb6,0x2f,0x69,0x5a
-,0x49,0x56,0xa5,0x42,0xa5,0x4d,0xeb,0x57,0x5f,0xdd,0x09,0xb2,0xef
-,0x02,0xaa,0xcb,0x12,0xd5,0x16,0xbf,0xed,0xb5,0x76,0x56,0xd2,0xb5
-,0x52,0xb5,0x15,0x42,0xa6,0x96,0xd5,0x5e,0xbb,0xac,0x1b,0x64,0xdb
-,0x05,0x55,0x5a,0x15,0x45,0x1b,0x55,0xb5,0x6d,0xf5,0x4e,0xd2,0xad
-,0x4a,0xaa,0x28,0x85,0x94,0xad,0x76,0xdb,0x5e,0xac,0x1b,0x65,0xf6
-,0x0a,0xa8,0xaa,0x25,0x4a,0x15,0xab,0x6c,0xab,0x74,0xad,0xa9,0x5b
-,0x4a,0xd5,0x50,0x8a,0x8c,0xba,0xdd,0x56,0xf6,0xa8,0x1b,0xc5,0xad
-,0x15,0x51,0x52,0x2b,0x28,0x2d,0x6b,0x68,0x9b,0x75,0x56,0x92,0xf6
-,0x55,0x45,0x40,0x2a,0x15,0x56,0xad,0xbd,0x6d,0xa8,0x2d,0x4b,0x5b
-,0x2a,0x85,0x4a,0xaa,0x90,0x75,0xb5,0x51,0xb6,0xa4,0xb6,0x92,0xd5
-,0x2a,0x2a,0x80,0xaa,0x14,0x56,0xd6,0xd9,0x5a,0xd1,0x2b,0x2b,0x7e
-,0x50,0x95,0x29,0x54,0x91,0x6a,0xab,0x65,0xad,0x68,0x5d,0x15,0xab
-,0x44,0x54,0x02,0xd4,0x24,0xad,0x6d,0xb2,0xdb,0x42,0x55,0x56,0xd5
-,0x11,0x52,0x97,0x29,0x10,0xd5,0x56,0xa5,0x6a,0xa8,0xaa,0x15,0xbe
-,0x42,0xa8,0x0a,0xa8,0xa4,0xaa,0xba,0xc6,0xb6,0xc2,0x5d,0x56,0xd5
-,0x0a,0x81,0x35,0xa2,0x11,0x5a,0xd5,0x55,0xab,0x50,0xa8,0x2b,0x77
-,0x54,0x48,0x5a,0xa9,0x25,0xa9,0x56,0x85,0x5a,0x8a,0x6d,0x6d,0xad
-,0x2a,0x02,0xad,0x40,0x80,0xb5,0x6b,0x56,0xd5,0x40,0xa8,0x96,0xf6
-,0xa8,0xa0,0xd6,0x55,0x2a,0xd2,0xb5,0x8a,0xad,0x92,0xb2,0x5b,0x5b
-,0x82,0x0a,0x2b,0x43,0x02,0xa5,0xad,0x2d,0x6a,0x08,0xd1,0xd6,0xd6
-,0x20,0x4d,0x94,0x8a,0x4a,0xa5,0x55,0x15,0xad,0x52,0xa8,0xad,0xbb
-,0x09,0x2b,0x64,0x8b,0x0a,0xa6,0xb6,0x56,0xb5,0x01,0x43,0x36,0xd6
-,0x40,0xb5,0xba,0x2d,0x2a,0x95,0x5a,0x2a,0xd4,0x55,0x69,0xbb,0x7b
-,0x15,0x5e,0xd4,0x15,0x0a,0xca,0xd4,0xaa,0xaa,0x21,0x86,0x56,0xd6
-,0x4b,0xaa,0xb4,0x96,0x92,0x8b,0x54,0x2d,0x55,0x4a,0x93,0x6d,0xbb
-,0x6c,0xeb,0x59,0x61,0x15,0x2a,0xb5,0x55,0xa8,0x22,0x8d,0x76,0xd5
-,0x96,0x3d,0xe8,0xbd,0x25,0x15,0x50,0x56,0xb5,0x4a,0x2a,0xad,0xbe
-,0xc5,0x86,0xa9,0xaa,0x14,0x96,0xaa,0x6a,0xa8,0x22,0x8d,0x76,0xd5
-,0x50,0x12,0xd6,0xd7,0x26,0x2a,0xd0,0xaa,0xa9,0x4a,0x35,0xab,0x6f
-,0x02,0x41,0x72,0x6a,0x10,0xab,0x54,0xb5,0x51,0x04,0x99,0x7d,0xb5
-,0x20,0x08,0x0d,0x1b,0x54,0x2d,0x51,0x55,0x64,0xa0,0x6d,0xab,0x6d
-,0x09,0x22,0x23,0xc5,0x22,0x55,0x45,0x55,0x42,0x0a,0x53,0x6d,0xb7
-,0x40,0x08,0x88,0xaa,0x30,0x55,0x51,0xa9,0x52,0xa0,0xba,0xdb,0x6d
-,0x15,0x40,0x24,0x71,0x24,0xaa,0x85,0x55,0x45,0x09,0x67,0x6d,0xb6
-,0x45,0x2a,0x02,0x1c,0x50,0xad,0xa2,0xaa,0x92,0x41,0xb5,0xb6,0xdb
-,0x09,0x45,0x49,0x46,0x24,0xb5,0x0a,0xa2,0x8a,0x15,0x4d,0x6d,0xb6
-,0x8a,0xa8,0x20,0x95,0x12,0xaa,0x95,0x52,0x24,0x82,0xeb,0xb6,0xdb
-,0x24,0x95,0x4a,0x43,0x42,0x95,0x05,0x45,0x14,0x27,0x56,0xdb,0x6d
-,0x4f,0x6d,0x24,0x11,0x4a,0xaa,0x55,0x94,0x8a,0x8a,0xad,0x6d,0xb7
-,0x2a,0xbe,0x92,0x84,0xa2,0x94,0x0a,0x84,0x2c,0x2b,0xb7,0xb6,0xda
-,0xaf,0xeb,0xa9,0x50,0xd0,0x2a,0xaa,0x24,0x91,0x15,0x14,0xdb,0x6d
-,0x9a,0xbd,0xac,0x22,0x35,0x14,0x15,0x08,0x58,0x4a,0x55,0x25,0xb7
-,0xad,0xae,0x95,0x48,0x50,0x51,0x2a,0x42,0xa9,0x36,0xea,0x92,0x4a
-,0x96,0xaa,0xc9,0x2a,0x1a,0x10,0x54,0x28,0x30,0x5a,0xb7,0xed,0x95
-,0x5b,0xad,0x64,0x95,0x29,0x85,0x51,0x42,0xa5,0x69,0x5a,0xb6,0xec
-,0x2d,0x55,0x52,0xa2,0x06,0xe0,0x54,0x91,0x60,0x5b,0xad,0x5b,0x5b
-,0xd7,0xaa,0xa9,0x55,0x53,0x5d,0x41,0x84,0xa9,0xaa,0xf7,0xed,0xb6
-,0x9a,0xad,0x45,0x49,0x55,0xaa,0xaa,0x97,0x42,0xd6,0xaa,0x56,0xdb
-,0xcd,0xb4,0xb2,0xaa,0x24,0xdd,0xdf,0x25,0xd2,0xba,0x95,0x5b,0x6d
-,0xab,0x55,0x55,0x55,0x57,0x6a,0xb5,0xda,0x87,0x69,0x20,0x21,0x56
-,0xd6,0xd5,0x5a,0x94,0x91,0x57,0x6a,0xb7,0x7a,0xa4,0x97,0xde,0xfb
-,0xad,0xaa,0xea,0xaa,0x4b,0xba,0xdf,0x6d,0xad,0xca,0x6a,0xb5,0x95
-,0xd6,0xeb,0x56,0xab,0xb2,0xd7,0x6a,0xda,0xd6,0xa3,0xbd,0x95,0x6e
-,0x77,0x55,0x6b,0x55,0x5b,0x6a,0xb7,0x6f,0x7b,0x5d,0x60,0x20,0x15
-,0xaa,0xf6,0xbd,0x5b,0xa9,0xbd,0xda,0xb5,0xad,0xab,0x04,0x95,0x41
-,0xdb,0x5b,0x6b,0x6a,0xed,0x56,0xad,0xda,0xd6,0xb4,0x90,0x48,0x14
-,0xb4,0xea,0xdd,0xad,0xb6,0xeb,0x76,0xaf,0x6b,0x68,0x25,0x02,0x80
-,0xdb,0x3a,0xaa,0xab,0x5b,0x5d,0xad,0xf5,0xbd,0x85,0x10,0xa8,0x24
-,0xad,0x17,0x76,0xb6,0xed,0xea,0xf6,0xad,0x54,0x54,0xaa,0x12,0x81
-,0xdb,0xcb,0x95,0x6f,0x5b,0x5f,0x5b,0xb6,0xef,0x92,0xd5,0x49,0x28
-,0x6d,0x70,0xf7,0xba,0xed,0xa9,0xad,0x6d,0xb5,0x4a,0xfd,0x54,0x92
-,0xb5,0xae,0x8a,0xd7,0x5a,0xf6,0xf7,0xb6,0xda,0x2b,0xaa,0xa2,0x49
-,0xda,0xb7,0x75,0x7a,0xef,0x5b,0x5a,0xdb,0x6d,0x55,0xfe,0xb9,0x24
-,0x57,0x6a,0xde,0xd7,0x5a,0xdd,0xd6,0xb6,0xd9,0x6a,0xab,0x24,0x92
-,0xda,0xbb,0x6b,0x6d,0xb7,0x6b,0x7b,0xdb,0x6b,0xaa,0xfa,0x92,0x4a
-,0xad,0xd6,0xda,0xda,0xed,0xb6,0xad,0x6d,0xb6,0xd5,0x4b,0x4a,0xa9
-,0xb6,0xab,0x6f,0x6f,0x5a,0xdb,0xd6,0xb6,0xdb,0x7d,0x6a,0x22,0x95
-,0xd5,0x75,0xb5,0xb5,0xef,0x6d,0x7b,0xdb,0x6d,0xaa,0xab,0x55,0x4a
-,0x5b,0xae,0xda,0xda,0xb5,0xb7,0x56,0xb6,0xdb,0x6d,0x55,0x4a,0xa5
-,0xd5,0x55,0x6f,0x6f,0x5a,0xda,0xed,0xdb,0x6d,0xb6,0xaa,0xaa,0x98
-,0x6d,0xbb,0xb5,0xb5,0xef,0x6f,0x5b,0x6d,0xb6,0xda,0xd5,0x55,0x55
-,0xb6,0xd5,0x5a,0xdd,0x5a,0xda,0xed,0xb6,0xdb,0x6e,0xad,0xb6,0xaa
-,0xd5,0x5b,0x6f,0x6b,0xb7,0x6d,0xb6,0xdb,0x6d,0xbb,0x56,0xd9,0x55
-,0xad,0xad,0xb5,0xbd,0x6d,0xb6,0xdb,0x6d,0xbb,0x6d,0x5a,0xad,0x55
-,0xb6,0xd6,0xda,0xd7,0xb6,0xdb,0x6d,0xb6,0xd6,0xd7,0xab,0xea,0xaa
-,0xdb,0x7b,0x6f,0x6a,0xdb,0x6d,0xb6,0xdb,0x7b,0xba,0xdd,0x5b,0x57
-,0xad,0x4d,0x5a,0xdd,0x6d,0xb6,0xdb,0x6d,0xad,0x6f,0x66,0xed,0x6a
-,0xd6,0xf5,0xed,0xb7,0xb6,0xdb,0x6d,0xb6,0xf7,0xb5,0xb5,0xb5,0xaf
-,0x7b,0x5b,0x56,0xda,0xdb,0x6d,0xb6,0xdb,0x5a,0xda,0xda,0xad,0x5a
-,0xad,0xad,0xbb,0x6d,0x6d,0xb6,0xdb,0x6d,0xd7,0x6f,0x5e,0xaa,0xef
-,0xd6,0xf6,0xdd,0xb7,0xb6,0xdb,0x6d,0xb6,0xba,0xb5,0xa3,0xf7,0x75
-,0xbb,0x5b,0x6b,0x6d,0x6d,0xad,0xb6,0xdb,0xd7,0xde,0xf8,0xad,0xae
-,0xd5,0xad,0xb6,0xdb,0xb6,0xd6,0xdb,0x6d,0x7a,0xb5,0x57,0x1b,0x7b
-,0xbe,0xf6,0xdb,0x6d,0x6d,0xab,0x6d,0xb7,0x56,0xdb,0xbd,0xe2,0xd6
-,0xd5,0x5b,0x6d,0xb7,0xb7,0x55,0xb6,0xed,0xdb,0x6d,0x6a,0xbd,0x09
-,0xb7,0xad,0xb6,0xda,0xda,0xdb,0x6d,0xb6,0xb6,0xdb,0xb7,0x56,0xee
-,0xda,0xf6,0xdb,0x6e,0xb7,0x56,0xdb,0x6d,0xdb,0x6d,0xda,0xeb,0x5b
-,0x6d,0x5b,0x6d,0xb5,0xda,0xbb,0x6d,0xb6,0xb6,0xf6,0xaf,0x5d,0xb5
-,0x57,0x6d,0xb6,0xde,0xb7,0xd5,0xb6,0xdb,0xdb,0xad,0xf5,0xb6,0xde
-,0x7a,0xd6,0xdb,0x6b,0xda,0xbe,0xdb,0x6d,0x6d,0x76,0xaa,0xda,0xab
-,0x57,0x7b,0x6d,0xbd,0x6e,0xd5,0xb6,0xf7,0xb7,0xad,0xb7,0x6b,0xf5
-,0x2a,0xad,0xb6,0xeb,0x5b,0x6e,0xdb,0xad,0x6d,0x76,0xda,0xad,0x2e
-,0x5d,0xd6,0xdb,0x5d,0xed,0x5b,0x6d,0x76,0xdb,0xad,0x6b,0x76,0xf5
-,0x2b,0x7b,0x6d,0xea,0xb7,0xb5,0xb7,0xad,0xb6,0xdb,0xad,0xab,0x5b
-,0x1d,0xad,0xb6,0xb7,0x5a,0xde,0xda,0xdb,0x6d,0x6d,0x76,0xb5,0xad
-,0x8a,0xd6,0xdb,0xad,0xed,0x6b,0x6f,0x6d,0xb7,0xb7,0xaa,0xdd,0x6b
-,0xaf,0x75,0x6d,0x76,0xb7,0xb5,0xb5,0xb6,0xda,0xda,0xdd,0x6b,0xb5
-,0x05,0x5f,0xb7,0xbb,0x6d,0x6e,0xdd,0x6f,0x77,0x6e,0xab,0xad,0x5d
-,0x53,0xa9,0x5a,0xd6,0xdb,0xb7,0x6b,0xba,0xda,0xb5,0xf6,0xb6,0xeb
-,0x45,0x77,0xed,0x6d,0xb6,0xda,0xdd,0xd7,0x6f,0xde,0xad,0xdb,0x55
-,0x22,0xda,0xb7,0xb6,0xdb,0x6d,0xb6,0xba,0xda,0xb5,0xda,0xad,0x6e
-,0x51,0x6d,0x5a,0xdb,0x6d,0xb6,0xdb,0x6d,0xb6,0xdb,0x6f,0x75,0xb5
-,0x94,0xb7,0xed,0x6d,0xb6,0xdb,0x6d,0xb6,0xdb,0x6d,0xb5,0xae,0xdb
-,0x91,0x5a,0xb7,0xb6,0xdb,0x6d,0xb6,0xdb,0x6d,0xb6,0xda,0xf5,0x6d
-,0x48,0xb6,0xda,0xdb,0x76,0xdb,0xdb,0x6d,0xdb,0x6d,0xb7,0x5b,0xb7
-,0xa4,0x5b,0x6d,0x6d,0xdb,0x6d,0x6d,0xb7,0x6d,0xb6,0xdb,0xad,0x5a
-,0xca,0x2d,0xb7,0xb7,0x6d,0xb7,0x76,0xed,0xb6,0xdb,0x6d,0x77,0xed
-,0x62,0x96,0xda,0xda,0x5b,0x7a,0xdb,0x5a,0xdd,0xed,0xb6,0xda,0xb7
-,0xaa,0x2b,0x6d,0x6f,0xad,0xd7,0x6d,0xef,0x6b,0x5b,0x6d,0xad,0xaa
-,0xb1,0x05,0xb7,0xb5,0x6b,0x6d,0xb6,0xb5,0xbd,0xb6,0xdb,0x76,0xfc
-,0xd5,0x53,0x5a,0xdd,0xb5,0xb6,0xdb,0xde,0xd6,0xdb,0xb6,0xdb,0x55
-,0x58,0x89,0xed,0x6b,0x6e,0xd1,0x6d,0x6b,0x77,0x6d,0x6d,0xb6,0xd0
-,0xd4,0xa4,0xb7,0xbd,0xbb,0x6f,0x37,0x5a,0xda,0xdb,0xbb,0x6d,0xaa
-,0xb4,0x4a,0x5a,0xd6,0xd6,0xdb,0xd5,0xef,0x6d,0xb6,0xd6,0xdb,0x52
-,0xda,0xa1,0x6d,0x6b,0x7b,0x76,0xb6,0xb5,0xb6,0xdd,0xbb,0xb6,0xa9
-,0x6e,0x2a,0x37,0xbd,0xad,0xad,0xdb,0xba,0xdb,0x6b,0x6d,0x6d,0x04
-,0xb3,0x11,0x55,0x6b,0x76,0xf6,0xb6,0xd7,0x6d,0xbd,0xb7,0xb6,0xaa
-,0xdd,0x48,0x0e,0xdd,0xab,0x5b,0xdd,0x6d,0xb6,0xd6,0xda,0xd8,0x41
-,0x6a,0x8d,0x55,0xab,0x7d,0xad,0x6b,0xb6,0xdb,0x77,0x6d,0x65,0x2a
-,0xbb,0x52,0x43,0x76,0xd6,0xf7,0x76,0xdb,0x6d,0xaa,0xdb,0x92,0x91
-,0xcd,0xc5,0x29,0xad,0xb7,0x5a,0xdb,0x6d,0xb6,0xfd,0xb6,0xa8,0x4a
-,0x76,0xa1,0x14,0xdb,0x6a,0xef,0x6d,0xb6,0xdb,0x56,0xda,0x15,0x21
-,0x56,0xd4,0xa2,0x6d,0xbd,0xb5,0xb6,0xdb,0x6d,0xdb,0x69,0x42,0x94
-,0x5b,0x71,0x55,0x5b,0x6b,0x5a,0xdb,0x6d,0xb6,0xad,0xa4,0xa8,0x45
-,0xab,0x58,0x40,0x36,0xdd,0xef,0x6d,0xb6,0xdb,0xf6,0x12,0x15,0x28
-,0x2d,0xad,0x2a,0x9b,0x6b,0x5a,0xdb,0x6d,0xb6,0x99,0x49,0x42,0x85
-,0x96,0xea,0x12,0x4d,0xb6,0xed,0xb6,0xdb,0x6d,0x64,0xa4,0xa8,0x52
-,0x4a,0xb5,0x49,0x26,0xdb,0x56,0xdb,0x6d,0xb6,0x92,0x12,0x15,0x11
-,0x56,0xdb,0x04,0x93,0x6d,0xfb,0x6d,0xb6,0xd8,0x89,0x49,0x42,0xaa
-,0x25,0x6d,0xaa,0x49,0xb6,0xad,0xb6,0xdb,0x45,0x54,0xa4,0xa8,0x01
-,0x93,0x5a,0x81,0x24,0xdb,0x56,0xdb,0x6c,0x28,0x8a,0x12,0x15,0x54
-,0x49,0xae,0xe8,0x92,0x6d,0xfb,0x6d,0x82,0x95,0x51,0x49,0x40,0x92
-,0x44,0xd5,0x52,0x49,0x36,0xad,0xb4,0x54,0xa2,0x2a,0x54,0xaa,0x49
-,0x52,0x6f,0xa8,0x2a,0x9b,0x56,0x82,0x92,0x15,0x45,0x0a,0x12,0x24
-,0x89,0x55,0x6e,0x88,0x4a,0xf4,0x54,0x49,0x48,0xa8,0xa1,0x49,0x49
-,0x54,0x2a,0xb5,0x25,0x25,0x02,0xaa,0xa4,0xa5,0x15,0x2a,0x52,0x24
-,0x82,0x9b,0x6a,0x82,0x90,0xaa,0x04,0x52,0x28,0xa2,0x89,0x09,0x52
-,0xa8,0x4a,0xbb,0x68,0xaa,0x49,0x6a,0x89,0x45,0x14,0x54,0xa4,0x09
-,0xa5,0x25,0x4d,0xa8,0x45,0x24,0x91,0x54,0xa8,0xa2,0x82,0x52,0xa4
-,0x92,0x92,0xb6,0xb6,0x28,0x92,0x4a,0x22,0x15,0x14,0x55,0x08,0x92
-,0xa4,0x49,0xaa,0xd5,0x8a,0x49,0x25,0x55,0x42,0xa2,0x90,0xa5,0x49
-,0x92,0x90,0x55,0x5a,0xa4,0xa4,0x90,0x88,0xa8,0x54,0x4a,0x50,0x24
-,0xa8,0x4a,0x55,0x55,0x53,0x12,0x4a,0x55,0x15,0x0a,0xa5,0x0a,0x92
-,0x85,0x21,0x16,0xaa,0xdc,0x89,0x25,0x22,0xa2,0xa2,0x10,0xa4,0xa9
-,0xa8,0x94,0x8a,0xab,0x55,0x62,0x90,0x94,0x54,0x55,0x4a,0x52,0x04
-,0xa5,0x44,0x42,0xb5,0x55,0xa8,0x4a,0x4a,0x8a,0x88,0xa5,0x09,0x52
-,0x80,0x2a,0x90,0xaa,0xaa,0xad,0x15,0x21,0x51,0x55,0x10,0xa4,0x95
-,0xa5,0x40,0x4a,0x55,0x55,0x55,0x40,0x94,0x2a,0x22,0xaa,0x52,0x40
-,0x41,0x2a,0xa1,0x0a,0xaa,0xaa,0x95,0x4a,0x85,0x54,0x45,0x09,0x2a
-,0x88,0x89,0x14,0x42,0xb5,0x6d,0x40,0x22,0x50,0x8a,0xa8,0xa4,0x92
-,0x20,0x54,0x8a,0x90,0x56,0xaa,0xba,0x95,0x2a,0x51,0x15,0x12,0x49
-,0x84,0x22,0x51,0x4a,0x01,0x55,0x54,0x00,0x89,0x2a,0xa0,0xa9,0x24
-,0x11,0x14,0x8a,0x21,0x54,0x2a,0xd5,0xaa,0x54,0x84,0x55,0x04,0x92
-,0x00,0x42,0x52,0x94,0x01,0x01,0x2a,0x81,0x22,0x52,0x88,0xaa,0x49
-,0x49,0x29,0x09,0x53,0x28,0xa8,0x45,0x74,0x15,0x29,0x55,0x21,0x24
-
-};
\ No newline at end of file
@@ -1,11 +0,0 @@
-#ifndef HELLO_H
-#define HELLO_H
-
-#include <stdint.h>
-#include <cc2530.h>
-
-#define BUFFER_SIZE 2756
-
-extern const __xdata uint8_t test1[BUFFER_SIZE];
-
-#endif
\ No newline at end of file
@@ -0,0 +1,332 @@
+#!/usr/bin/env python3
+"""
+assets.py — compile PNG frames and fonts into __code tables
+
+  python assets.py -o out/assets frame:assets/test1.png font:assets/font5x7.png
+  python assets.py -o out/assets @assets/assets.list
+
+Writes out/assets.c and out/assets.h (see asset.h for the index format)
+and prints the size and compression of every asset. Called by the
+Makefile; only the standard library is needed.
+
+  --bank 2 --bank 3  banked builds: frame data goes into flash banks 2
+                   and 3, in out/assets_bank2.c and out/assets_bank3.c;
+                   the index and fonts stay in out/assets.c, common area.
+
+  frame:file.png   104x212 (portrait, framebuffer layout) or 212x104
+                   (landscape, as text mode draws it), dark pixels black.
+                   PackBits-compressed unless that is larger than raw.
+  font:file.png    glyph sheet, 16 columns x 6 rows of cells for 0x20-0x7F.
+                   The last column and row of a cell are spacing. Stored
+                   raw, glyph-major, one byte per column, bit0 = top pixel.
+
+Asset names come from the file name: assets/font5x7.png -> ASSET_FONT5X7.
+assets/assets.list holds the firmware's assets, one kind:file per line,
+paths relative to the repository root.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+ROOT             = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+ASSET_LIST       = os.path.join(ROOT, "assets", "assets.list")
+
+FRAME_W, FRAME_H = 104, 212
+FRAME_SIZE       = FRAME_W * FRAME_H // 8
+BANK_SIZE        = 0x8000
+
+KIND_FRAME, KIND_FONT  = 0, 1
+ENC_RAW, ENC_PACKBITS  = 0, 1
+ENC_NAMES = {ENC_RAW: "raw", ENC_PACKBITS: "packbits"}
+
+
+# ── PNG ───────────────────────────────────────────────────────────────────────
+def load_png(path):
+    """→ (width, height, rows of 0-255 luma). Non-interlaced PNGs only."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError(f"{path}: not a PNG")
+
+    pos, idat, palette = 8, b"", None
+    while pos < len(data):
+        n, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + n]
+        pos += 12 + n
+        if kind == b"IHDR":
+            w, h, depth, ctype, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"PLTE":
+            palette = [chunk[i:i + 3] for i in range(0, n, 3)]
+        elif kind == b"IDAT":
+            idat += chunk
+        elif kind == b"IEND":
+            break
+    if interlace:
+        raise ValueError(f"{path}: interlaced PNGs are not supported")
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[ctype]
+    bpp      = max(1, channels * depth // 8)            # filter unit
+    stride   = (w * channels * depth + 7) // 8
+    raw      = zlib.decompress(idat)
+
+    rows, prev = [], bytearray(stride)
+    for y in range(h):
+        ftype = raw[y * (stride + 1)]
+        line  = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if ftype == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif ftype == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif ftype == 3:
+                line[i] = (line[i] + (a + b) // 2) & 0xFF
+            elif ftype == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                line[i] = (line[i] + (a if pa <= pb and pa <= pc
+                                      else b if pb <= pc else c)) & 0xFF
+        prev = line
+
+        # unpack samples, keep the first channel (or palette luma)
+        if depth < 8:
+            mask = (1 << depth) - 1
+            samples = [(line[(x * depth) // 8] >> (8 - depth - (x * depth) % 8)) & mask
+                       for x in range(w)]
+        else:
+            step = channels * depth // 8
+            samples = [line[x * step] for x in range(w)]
+
+        if ctype == 3:
+            samples = [sum(palette[s]) // 3 for s in samples]
+        elif depth < 8:
+            samples = [s * 255 // ((1 << depth) - 1) for s in samples]
+        elif ctype in (2, 6):
+            step = channels * depth // 8
+            samples = [sum(line[x * step + k * depth // 8] for k in range(3)) // 3
+                       for x in range(w)]
+        rows.append(samples)
+    return w, h, rows
+
+
+# ── converters ────────────────────────────────────────────────────────────────
+def frame_from_png(path):
+    """→ framebuffer bytes, 1 = white, MSB first."""
+    w, h, rows = load_png(path)
+    if (w, h) == (FRAME_H, FRAME_W):                    # landscape: rotate
+        rows = [[rows[FRAME_W - 1 - x][y] for x in range(FRAME_W)]
+                for y in range(FRAME_H)]
+    elif (w, h) != (FRAME_W, FRAME_H):
+        raise ValueError(f"{path}: frames are {FRAME_W}x{FRAME_H} or "
+                         f"{FRAME_H}x{FRAME_W}, got {w}x{h}")
+    out = bytearray()
+    for row in rows:
+        for x in range(0, FRAME_W, 8):
+            out.append(sum((row[x + i] >= 128) << (7 - i) for i in range(8)))
+    return bytes(out)
+
+
+def font_from_png(path):
+    """→ (glyph width, glyph height, column bytes for 96 glyphs)."""
+    w, h, rows = load_png(path)
+    if w % 16 or h % 6:
+        raise ValueError(f"{path}: glyph sheet must be 16x6 cells, got {w}x{h}")
+    cw, ch = w // 16, h // 6
+    gw, gh = cw - 1, ch - 1
+    if gh > 8:
+        raise ValueError(f"{path}: glyphs taller than 8 pixels")
+    out = bytearray()
+    for g in range(96):
+        x0, y0 = (g % 16) * cw, (g // 16) * ch
+        for gx in range(gw):
+            out.append(sum((rows[y0 + gy][x0 + gx] < 128) << gy
+                           for gy in range(gh)))
+    return gw, gh, bytes(out)
+
+
+def packbits(data):
+    """PackBits: n < 128 -> n+1 literals, n > 128 -> byte repeated 257-n."""
+    out, i = bytearray(), 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 3:
+            out += bytes([257 - run, data[i]])
+            i += run
+            continue
+        j = i
+        while j < len(data) and j - i < 128:
+            if j + 2 < len(data) and data[j] == data[j + 1] == data[j + 2]:
+                break
+            j += 1
+        out += bytes([j - i - 1]) + data[i:j]
+        i = j
+    return bytes(out)
+
+
+def unpackbits(data):
+    out, i = bytearray(), 0
+    while i < len(data):
+        n = data[i]
+        if n < 128:
+            out += data[i + 1:i + 2 + n]
+            i += 2 + n
+        elif n > 128:
+            out += bytes([data[i + 1]]) * (257 - n)
+            i += 2
+        else:
+            i += 1
+    return bytes(out)
+
+
+# ── output ────────────────────────────────────────────────────────────────────
+def asset_name(path):
+    return re.sub(r"\W", "_", os.path.splitext(os.path.basename(path))[0]).upper()
+
+
+def compile_asset(spec):
+    kind, _, path = spec.partition(":")
+    if kind == "frame":
+        raw = frame_from_png(path)
+        packed = packbits(raw)
+        assert unpackbits(packed) == raw
+        enc, data = (ENC_PACKBITS, packed) if len(packed) < len(raw) \
+            else (ENC_RAW, raw)
+        return dict(name=asset_name(path), kind=KIND_FRAME, enc=enc,
+                    w=FRAME_W, h=FRAME_H, raw=len(raw), data=data)
+    if kind == "font":
+        gw, gh, raw = font_from_png(path)
+        return dict(name=asset_name(path), kind=KIND_FONT, enc=ENC_RAW,
+                    w=gw, h=gh, raw=len(raw), data=raw)
+    raise ValueError(f"{spec}: expected frame:<png> or font:<png>")
+
+
+def load_list(path=ASSET_LIST):
+    """Compile every asset in an assets.list, in firmware id order."""
+    with open(path) as f:
+        specs = [l.strip() for l in f if l.strip() and not l.startswith("#")]
+    return [compile_asset(f"{k}:{os.path.join(ROOT, p)}")
+            for k, _, p in (s.partition(":") for s in specs)]
+
+
+def c_bytes(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join(f"0x{b:02X}" for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def place(assets, banks):
+    """Set each asset's flash bank: frames fill the given banks in order,
+    fonts stay in the common area (text.c reads them directly)."""
+    fill = {n: 0 for n in banks}
+    for a in assets:
+        a["bank"] = 0
+        if a["kind"] != KIND_FRAME:
+            continue
+        for n in banks:
+            if fill[n] + len(a["data"]) <= BANK_SIZE:
+                a["bank"] = n
+                fill[n] += len(a["data"])
+                break
+        else:
+            if banks:
+                raise ValueError(f"{a['name']}: no room in banks "
+                                 f"{', '.join(map(str, banks))}")
+
+
+def c_array(a):
+    """Global, so banks.py finds it in the linker map"""
+    return [f"__code const uint8_t asset_data_{a['name'].lower()}"
+            f"[{len(a['data'])}] = {{", c_bytes(a["data"]), "};", ""]
+
+
+def write_outputs(assets, base, sources, banks=()):
+    guard = "ASSETS_H"
+    header = [f"/* Generated by host_script/assets.py from {' '.join(sources)}",
+              " * Do not edit, rebuild with make. */",
+              f"#ifndef {guard}", f"#define {guard}", "",
+              '#include "asset.h"', "",
+              f"#define ASSET_COUNT  {len(assets)}", ""]
+    for i, a in enumerate(assets):
+        header.append(f"#define ASSET_{a['name']:<12} {i}")
+        header.append(f"#define ASSET_{a['name'] + '_W':<12} {a['w']}")
+        header.append(f"#define ASSET_{a['name'] + '_H':<12} {a['h']}")
+    header += ["", "extern __code const asset_t assets[ASSET_COUNT];", "",
+               f"#endif /* {guard} */", ""]
+
+    src = [f"/* Generated by host_script/assets.py, do not edit */",
+           "#include <stdint.h>", '#include "assets.h"', ""]
+    externs = [f"extern __code const uint8_t asset_data_{a['name'].lower()}"
+               f"[{len(a['data'])}];" for a in assets if a["bank"]]
+    src += externs + ([""] if externs else [])
+    for a in assets:
+        if not a["bank"]:
+            src += c_array(a)
+    src.append("__code const asset_t assets[ASSET_COUNT] = {")
+    for a in assets:
+        kind = "ASSET_KIND_FRAME" if a["kind"] == KIND_FRAME else "ASSET_KIND_FONT"
+        enc  = "ASSET_ENC_PACKBITS" if a["enc"] == ENC_PACKBITS else "ASSET_ENC_RAW"
+        src.append(f"    {{ {kind}, {enc}, {a['w']}, {a['h']}, {len(a['data'])}, "
+                   f"{a['bank']}, asset_data_{a['name'].lower()} }},")
+    src += ["};", ""]
+
+    with open(base + ".h", "w") as f:
+        f.write("\n".join(header))
+    with open(base + ".c", "w") as f:
+        f.write("\n".join(src))
+
+    # One file per bank, compiled with --constseg BANKn (Makefile)
+    for n in banks:
+        bank = [f"/* Generated by host_script/assets.py, do not edit",
+                f" * Asset data for flash bank {n} */",
+                "#include <stdint.h>", ""]
+        for a in assets:
+            if a["bank"] == n:
+                bank += c_array(a)
+        with open(f"{base}_bank{n}.c", "w") as f:
+            f.write("\n".join(bank))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="PNG/font -> __code asset tables",
+                                 fromfile_prefix_chars="@")
+    ap.add_argument("-o", "--output", required=True,
+                    help="output base name, writes <base>.c and <base>.h")
+    ap.add_argument("--bank", type=int, action="append", default=[],
+                    help="flash bank for frame data (banked builds, repeat "
+                         "for more), also writes <base>_bank<n>.c")
+    ap.add_argument("assets", nargs="+", metavar="kind:file.png")
+    args = ap.parse_args()
+
+    try:
+        assets = [compile_asset(s) for s in args.assets]
+        place(assets, args.bank)
+    except (OSError, ValueError) as e:
+        sys.exit(f"assets.py: {e}")
+    write_outputs(assets, args.output, [s.partition(":")[2] for s in args.assets],
+                  args.bank)
+
+    total_raw = total = 0
+    head = f"  {'asset':<14} {'kind':<6} {'raw':>6} {'flash':>6} {'ratio':>6}  enc"
+    print(f"{head:<58}  bank" if args.bank else head)
+    for a in assets:
+        kind = "frame" if a["kind"] == KIND_FRAME else "font"
+        line = (f"  {a['name']:<14} {kind:<6} {a['raw']:>6} {len(a['data']):>6} "
+                f"{len(a['data']) / a['raw']:>6.2f}  {ENC_NAMES[a['enc']]}")
+        print(f"{line:<58}  {a['bank'] or 'common'}" if args.bank else line)
+        total_raw += a["raw"]
+        total     += len(a["data"])
+    print(f"  {'total':<14} {'':<6} {total_raw:>6} {total:>6} "
+          f"{total / total_raw:>6.2f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+banks.py — physical image and bank report for banked builds
+
+  python banks.py out/banked/firmware.ihx -o out/banked/firmware.bin \\
+         --map out/banked/firmware.map --report out/banked/firmware.banks
+
+A banked build (make BANKED=1) links bank N at 0xN8000-0xNFFFF, the
+address it has when FMAP = N maps it into the 0x8000 code window. In
+flash, bank N is at N * 0x8000; the common area 0x0000-0x7FFF is bank 0.
+This writes the flat physical image CCLib and flash.py expect, checks that
+nothing overflowed its bank, and prints how full each bank is. With
+--map, the report also lists every linker area and function by bank, so
+you can see which calls cross banks, and where each asset's data went
+(assets.py places frames in banks, fonts in the common area).
+"""
+
+import argparse
+import re
+import sys
+
+BANK_SIZE   = 0x8000
+FLASH_SIZE  = 0x40000           # CC2530F256
+BANK_COUNT  = FLASH_SIZE // BANK_SIZE
+LOCK_PAGE   = FLASH_SIZE - 2048     # flash lock bits, the bootloader won't write it
+
+
+def load_ihx(path):
+    """Intel HEX → {address: byte} with extended segment/linear records."""
+    mem, upper = {}, 0
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith(":"):
+                continue
+            rec = bytes.fromhex(line[1:])
+            if sum(rec) & 0xFF:
+                raise ValueError(f"{path}: bad checksum in {line}")
+            n, addr, kind, data = rec[0], rec[1] << 8 | rec[2], rec[3], rec[4:4 + rec[0]]
+            if kind == 0x00:
+                for i in range(n):
+                    mem[upper + addr + i] = data[i]
+            elif kind == 0x02:
+                upper = (data[0] << 8 | data[1]) << 4
+            elif kind == 0x04:
+                upper = (data[0] << 8 | data[1]) << 16
+            elif kind == 0x01:
+                break
+    return mem
+
+
+def is_banked(mem):
+    return any(a > 0xFFFF for a in mem)
+
+
+def virt_to_phys(addr):
+    """Linker address → flash address."""
+    bank = addr >> 16
+    if bank == 0:
+        return addr
+    if (addr & 0xFFFF) < 0x8000 or bank >= BANK_COUNT:
+        raise ValueError(f"0x{addr:05x} is outside bank {bank}'s window")
+    return bank * BANK_SIZE + (addr & 0x7FFF)
+
+
+def physical(mem):
+    """{linker address: byte} → {flash address: byte}, checking overflow."""
+    if not is_banked(mem):
+        return dict(mem)
+    common = [a for a in mem if a <= 0xFFFF]
+    if common and max(common) >= BANK_SIZE:
+        raise ValueError(f"common area overflow: code up to 0x{max(common):04x}, "
+                         f"limit 0x{BANK_SIZE - 1:04x}; move files into banks")
+    phys = {virt_to_phys(a): b for a, b in mem.items()}
+    if max(phys) >= LOCK_PAGE:
+        raise ValueError(f"bank {BANK_COUNT - 1} overflow: code up to "
+                         f"0x{max(phys):05x}, the page from 0x{LOCK_PAGE:05x} "
+                         f"holds the lock bits")
+    return phys
+
+
+def usage(phys):
+    """→ [(bank, used bytes, lowest, highest)] for banks with content."""
+    banks = {}
+    for a in phys:
+        banks.setdefault(a // BANK_SIZE, []).append(a)
+    return [(n, len(v), min(v), max(v)) for n, v in sorted(banks.items())]
+
+
+# ── linker map ────────────────────────────────────────────────────────────────
+AREA_RE = re.compile(r"^(\w+)\s+([0-9A-Fa-f]{4,8})\s+([0-9A-Fa-f]{4,8})\s*=\s*(\d+)\.\s*bytes")
+SYM_RE  = re.compile(r"^\s+(?:[0-9A-Fa-f]{2}:)?([0-9A-Fa-f]{4,8})\s+(_\w+)\s+(\w+)\s*$")
+
+
+ASSET_PREFIX = "_asset_data_"
+
+
+def parse_map(path):
+    """aslink .map → (areas [(name, addr, size)], symbols [(addr, name, module)],
+    assets [(addr, name, size)])."""
+    areas, symbols, data, area = [], [], [], None
+    with open(path) as f:
+        for line in f:
+            m = AREA_RE.match(line)
+            if m:
+                area = m.group(1)
+                areas.append((area, int(m.group(2), 16), int(m.group(4))))
+                continue
+            m = SYM_RE.match(line)
+            if not m or not area:
+                continue
+            sym = (int(m.group(1), 16), m.group(2), m.group(3))
+            if area in ("CSEG", "HOME") or area.startswith("BANK"):
+                symbols.append(sym)
+            elif area == "CONST":
+                data.append(sym)
+
+    # Asset arrays are in CONST (common) or a BANKn area (--constseg),
+    # each one runs up to the next symbol or the end of its area
+    assets = []
+    everything = sorted(set(symbols + data))
+    ends = [a + size for _, a, size in areas]
+    for i, (addr, name, _) in enumerate(everything):
+        if name.startswith(ASSET_PREFIX):
+            nxt = [a for a, _, _ in everything[i + 1:i + 2]] + \
+                  [e for e in ends if e > addr]
+            assets.append((addr, name[len(ASSET_PREFIX):], min(nxt) - addr))
+    symbols = [s for s in symbols if not s[1].startswith(ASSET_PREFIX)]
+    return areas, sorted(set(symbols)), assets
+
+
+def bank_of(addr):
+    return addr >> 16 if addr > 0xFFFF else 0
+
+
+def report(phys, banked, map_path=None):
+    lines = ["bank  flash range        used   free   (of 32768)"]
+    for n, used, lo, hi in usage(phys):
+        lines.append(f"{n:>4}  0x{lo:05x}-0x{hi:05x}  {used:>6} {BANK_SIZE - used:>6}"
+                     + ("   common" if n == 0 and banked else ""))
+    lines.append(f"total {sum(u for _, u, _, _ in usage(phys))} bytes")
+
+    if map_path:
+        areas, symbols, assets = parse_map(map_path)
+        lines += ["", "area          address   bytes"]
+        for name, addr, size in areas:
+            if size and (name in ("CSEG", "HOME", "CONST", "XINIT", "GSINIT",
+                                  "GSFINAL") or name.startswith("BANK")):
+                lines.append(f"{name:<12}  0x{addr:05x}  {size:>6}")
+        for n in sorted({bank_of(a) for a, _, _ in symbols}):
+            lines += ["", f"bank {n} functions" + (" (common, nonbanked calls)"
+                                                  if n == 0 else "")]
+            syms = [s for s in symbols if bank_of(s[0]) == n]
+            for i, (addr, name, module) in enumerate(syms):
+                size = syms[i + 1][0] - addr if i + 1 < len(syms) else None
+                lines.append(f"  0x{addr:05x}  {size if size is not None else '':>6}  "
+                             f"{name[1:]:<32} {module}")
+        if assets:
+            lines += ["", "asset         bank    address   bytes"]
+            for addr, name, size in assets:
+                lines.append(f"{name:<12}  {bank_of(addr) or 'common':<6}  "
+                             f"0x{addr:05x}  {size:>6}")
+    return "\n".join(lines)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="banked .ihx → physical .bin + report")
+    ap.add_argument("ihx")
+    ap.add_argument("-o", "--output", help="flat physical image to write")
+    ap.add_argument("--map", help="linker .map for the per-function report")
+    ap.add_argument("--report", help="write the full report to this file")
+    args = ap.parse_args()
+
+    try:
+        mem  = load_ihx(args.ihx)
+        phys = physical(mem)
+    except (OSError, ValueError) as e:
+        sys.exit(f"banks.py: {e}")
+
+    if args.output:
+        image = bytearray(b"\xff" * (max(phys) + 1))
+        for a, b in phys.items():
+            image[a] = b
+        with open(args.output, "wb") as f:
+            f.write(image)
+
+    text = report(phys, is_banked(mem), args.map)
+    if args.report:
+        with open(args.report, "w") as f:
+            f.write(text + "\n")
+    print("\n".join(text.split("\n\n")[0].splitlines()))   # bank summary only
+
+
+if __name__ == "__main__":
+    main()
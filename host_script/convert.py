@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""
+convert.py — images to framebuffers for send.py / einkd.py
+
+  python convert.py photo.jpg -o photo.bin
+  python convert.py labels/*.png -o out/ -j 8 --dither bayer
+  python convert.py logo.png -o logo.bin --preview logo-preview.png
+
+Loads any image Pillow reads, turns it to landscape 212x104 (what the
+label shows; portrait 104x212 with --portrait), scales it (--fit), dithers
+it and packs it into the 2756-byte layout EPD_SendFrame() expects: 13
+bytes per panel row, MSB first, 1 = white.
+
+Dithering: fs (Floyd-Steinberg, Pillow's C implementation), bayer (8x8
+ordered, numpy) or threshold. Packing is np.packbits on the whole frame.
+
+Results are cached by content: the hash of the input bytes and options
+names a file in --cache (default ~/.cache/eink-convert), so re-running a
+repricing batch only converts labels that changed. Batches are spread
+over -j processes.
+
+Requires: numpy, Pillow
+"""
+
+import argparse
+import hashlib
+import os
+import sys
+import time
+from concurrent.futures import ProcessPoolExecutor
+
+import numpy as np
+from PIL import Image, ImageOps
+
+FRAME_W, FRAME_H = 104, 212          # panel scan layout
+FRAME_SIZE       = FRAME_W * FRAME_H // 8
+CACHE_DIR        = os.environ.get("EINK_CACHE",
+                                  os.path.expanduser("~/.cache/eink-convert"))
+CACHE_VERSION    = b"1"              # bump when the output of a setting changes
+
+# 8x8 Bayer matrix, thresholds in (0, 255)
+_b2    = np.array([[0, 2], [3, 1]])
+_b4    = np.block([[4 * _b2, 4 * _b2 + 2], [4 * _b2 + 3, 4 * _b2 + 1]])
+BAYER8 = (np.block([[4 * _b4, 4 * _b4 + 2], [4 * _b4 + 3, 4 * _b4 + 1]])
+          + 0.5) * 256 / 64
+
+
+# ── conversion ────────────────────────────────────────────────────────────────
+def fit_image(img, size, fit):
+    """Grayscale img scaled to size: contain (white bars), cover (crop) or
+    stretch."""
+    img = ImageOps.exif_transpose(img)
+    if img.mode in ("RGBA", "LA", "P"):
+        img = img.convert("RGBA")
+        bg  = Image.new("RGBA", img.size, "white")
+        img = Image.alpha_composite(bg, img)
+    img = img.convert("L")
+    if fit == "stretch":
+        return img.resize(size, Image.LANCZOS)
+    if fit == "cover":
+        return ImageOps.fit(img, size, Image.LANCZOS)
+    return ImageOps.pad(img, size, Image.LANCZOS, color=255)
+
+
+def dither(gray, method, threshold=128):
+    """uint8 gray array → bool array, True = white."""
+    if method == "fs":
+        img = Image.fromarray(gray).convert("1", dither=Image.FLOYDSTEINBERG)
+        return np.asarray(img, dtype=bool)
+    if method == "bayer":
+        h, w = gray.shape
+        tile = np.tile(BAYER8, (h // 8 + 1, w // 8 + 1))[:h, :w]
+        return gray > tile
+    return gray >= threshold
+
+
+def to_panel(white, portrait):
+    """Label-oriented bool image → panel scan layout (212 rows x 104)."""
+    return white if portrait else np.rot90(white, -1)
+
+
+def pack(white):
+    """212x104 bool → 2756 bytes, MSB first, 1 = white."""
+    return np.packbits(white, axis=1).tobytes()
+
+
+def unpack(frame):
+    """2756 bytes → 212x104 bool, True = white."""
+    bits = np.unpackbits(np.frombuffer(frame, dtype=np.uint8))
+    return bits.reshape(FRAME_H, FRAME_W).astype(bool)
+
+
+def convert_image(img, dither_method="fs", fit="contain", portrait=False,
+                  invert=False, threshold=128):
+    size = (FRAME_W, FRAME_H) if portrait else (FRAME_H, FRAME_W)
+    gray = np.asarray(fit_image(img, size, fit), dtype=np.uint8)
+    if invert:
+        gray = 255 - gray
+    return pack(to_panel(dither(gray, dither_method, threshold), portrait))
+
+
+def preview(frame, path, portrait=False):
+    """Write a framebuffer as the label shows it."""
+    white = unpack(frame)
+    if not portrait:
+        white = np.rot90(white, 1)
+    Image.fromarray(white.astype(np.uint8) * 255).save(path)
+
+
+# ── cache ─────────────────────────────────────────────────────────────────────
+def cache_key(data, opts):
+    h = hashlib.sha256(CACHE_VERSION)
+    h.update(repr(sorted(opts.items())).encode())
+    h.update(data)
+    return h.hexdigest()
+
+
+def convert_file(path, opts, cache=CACHE_DIR):
+    """→ (frame, cached). Reads from / writes to the cache unless cache is None."""
+    with open(path, "rb") as f:
+        data = f.read()
+    cached_path = None
+    if cache:
+        key = cache_key(data, opts)
+        cached_path = os.path.join(cache, key[:2], key + ".bin")
+        try:
+            with open(cached_path, "rb") as f:
+                frame = f.read()
+            if len(frame) == FRAME_SIZE:
+                return frame, True
+        except OSError:
+            pass
+
+    with Image.open(path) as img:
+        frame = convert_image(img, **opts)
+
+    if cached_path:
+        os.makedirs(os.path.dirname(cached_path), exist_ok=True)
+        tmp = f"{cached_path}.{os.getpid()}.tmp"
+        with open(tmp, "wb") as f:
+            f.write(frame)
+        os.replace(tmp, cached_path)          # atomic vs parallel workers
+    return frame, False
+
+
+def load_frame(path, **opts):
+    """Framebuffer from a .bin (as is) or any image (converted, cached)."""
+    if path.endswith(".bin"):
+        with open(path, "rb") as f:
+            return f.read()
+    return convert_file(path, opts)[0]
+
+
+# ── batch ─────────────────────────────────────────────────────────────────────
+def _job(args):
+    src, dst, opts, cache, preview_path = args
+    frame, cached = convert_file(src, opts, cache)
+    with open(dst, "wb") as f:
+        f.write(frame)
+    if preview_path:
+        preview(frame, preview_path, opts["portrait"])
+    return src, cached
+
+
+def main():
+    ap = argparse.ArgumentParser(description="image → e-ink framebuffer")
+    ap.add_argument("inputs", nargs="+")
+    ap.add_argument("-o", "--output", required=True,
+                    help="output .bin, or a directory for several inputs")
+    ap.add_argument("--dither", choices=("fs", "bayer", "threshold"),
+                    default="fs")
+    ap.add_argument("--threshold", type=int, default=128)
+    ap.add_argument("--fit", choices=("contain", "cover", "stretch"),
+                    default="contain")
+    ap.add_argument("--portrait", action="store_true",
+                    help="input is 104x212 portrait, not 212x104 landscape")
+    ap.add_argument("--invert", action="store_true")
+    ap.add_argument("--preview", help="also write the result as a PNG "
+                    "(directory for several inputs)")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count(),
+                    help="worker processes (default: all CPUs)")
+    ap.add_argument("--cache", default=CACHE_DIR)
+    ap.add_argument("--no-cache", action="store_true")
+    args = ap.parse_args()
+
+    opts  = {"dither_method": args.dither, "fit": args.fit,
+             "portrait": args.portrait, "invert": args.invert,
+             "threshold": args.threshold}
+    cache = None if args.no_cache else args.cache
+    many  = len(args.inputs) > 1 or os.path.isdir(args.output)
+
+    jobs = []
+    for src in args.inputs:
+        stem = os.path.splitext(os.path.basename(src))[0]
+        dst  = os.path.join(args.output, stem + ".bin") if many else args.output
+        pv   = None
+        if args.preview:
+            pv = os.path.join(args.preview, stem + ".png") if many else args.preview
+        jobs.append((src, dst, opts, cache, pv))
+    if many:
+        os.makedirs(args.output, exist_ok=True)
+        if args.preview:
+            os.makedirs(args.preview, exist_ok=True)
+
+    start = time.monotonic()
+    if len(jobs) == 1 or args.jobs <= 1:
+        results = [_job(j) for j in jobs]
+    else:
+        with ProcessPoolExecutor(max_workers=args.jobs) as pool:
+            results = list(pool.map(_job, jobs, chunksize=16))
+    wall = time.monotonic() - start
+
+    hits = sum(cached for _, cached in results)
+    print(f"[convert] {len(results)} frame(s), {len(results) - hits} converted, "
+          f"{hits} from cache, {wall:.2f} s "
+          f"({len(results) / wall if wall else 0:.0f}/s)", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
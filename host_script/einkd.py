@@ -0,0 +1,366 @@
+#!/usr/bin/env python3
+"""
+einkd.py — long-running daemon that owns the tag serial ports
+
+Commands:
+  python einkd.py serve --device tag0=/dev/ttyACM1 [--device ...]
+  python einkd.py show    <device> <file.bin> [--wait]
+  python einkd.py clear   <device> [--wait]
+  python einkd.py metrics
+
+Socket API (Unix stream socket, one JSON object per line each way):
+  {"op": "show",  "device": "tag0", "file": "/abs/path.bin"}   (or an image)
+  {"op": "show",  "device": "tag0", "data": "<base64 framebuffer>"}
+  {"op": "clear", "device": "tag0"}
+  {"op": "metrics"}
+  Add "wait": true to get the reply once the update is on the panel,
+  otherwise the reply only confirms the job was queued.
+  Replies are {"ok": true, ...} or {"ok": false, "error": "..."}.
+
+Updates are latest-wins per device: a job still waiting in a device's
+queue is replaced by a newer one (its waiters get "superseded": true).
+A newer job arriving while a frame uploads also cancels the refresh of
+the stale frame. Serial ports are opened once and kept open, so jobs do
+not pay the 0.5 s CDC settle time of send.py.
+
+Uploads are pipelined with refreshes: the write returns at the first
+ACK (cmd_write(wait=False)) and the next job's frame is uploaded while
+the panel refreshes, which the firmware allows for CMD_SEND. The
+refresh's "EPD done" ACK is read before any other command; a job's
+wait reply and refresh_s come from that ACK.
+"""
+
+import argparse
+import base64
+import collections
+import json
+import os
+import signal
+import socket
+import socketserver
+import sys
+import threading
+import time
+
+import send
+from send import (FRAMEBUFFER_SIZE, open_serial, cmd_send, cmd_write,
+                  cmd_clear, cmd_hash, frame_hash, load_frame, wait_ack)
+
+SOCKET_PATH     = os.environ.get("EINKD_SOCKET", "/tmp/einkd.sock")
+LATENCY_SAMPLES = 256      # per-device window for latency percentiles
+ACK_POLL_S      = 0.02     # idle check for the deferred refresh ACK
+
+
+# ── jobs ──────────────────────────────────────────────────────────────────────
+class Job:
+    def __init__(self, kind, frame=None):
+        self.kind    = kind                  # "show" | "clear"
+        self.frame   = frame
+        self.hash    = frame_hash(frame) if frame is not None else None
+        self.created = time.monotonic()
+        self.done    = threading.Event()
+        self.result  = None
+
+    def finish(self, **result):
+        self.result = result
+        self.done.set()
+
+
+class Superseded(Exception):
+    pass
+
+
+# ── per-device worker ─────────────────────────────────────────────────────────
+class Device:
+    def __init__(self, name, port):
+        self.name    = name
+        self.port    = port
+        self.ser     = None
+        self.cond    = threading.Condition()
+        self.pending = None                  # latest-wins slot
+        self.active  = None
+        self.refreshing = None               # job whose "EPD done" is due
+        self.refresh_t  = None
+        self.buffer  = None                  # MCU buffer hash, last seen
+
+        self.counts    = collections.Counter()
+        self.latency   = collections.deque(maxlen=LATENCY_SAMPLES)
+        self.upload_s  = collections.deque(maxlen=LATENCY_SAMPLES)
+        self.refresh_s = collections.deque(maxlen=LATENCY_SAMPLES)
+
+        threading.Thread(target=self._run, name=f"dev-{name}",
+                         daemon=True).start()
+
+    def submit(self, job):
+        with self.cond:
+            if self.pending is not None:
+                self.pending.finish(ok=True, superseded=True)
+                self.counts["coalesced"] += 1
+            self.pending = job
+            self.counts["submitted"] += 1
+            self.cond.notify()
+
+    def _take(self):
+        """Next job, or None once the refresh in progress has ACKed."""
+        with self.cond:
+            while self.pending is None:
+                if self.refreshing is not None and self.ser.in_waiting:
+                    return None
+                self.cond.wait(ACK_POLL_S if self.refreshing is not None
+                               else None)
+            self.active, self.pending = self.pending, None
+            return self.active
+
+    def _newer_pending(self):
+        with self.cond:
+            return self.pending is not None
+
+    def _serial(self):
+        if self.ser is None:
+            self.ser = open_serial(self.port)
+            time.sleep(0.5)                  # let CDC enumerate, once
+            self.ser.reset_input_buffer()
+        return self.ser
+
+    def _drop_serial(self):
+        if self.ser is not None:
+            try:
+                self.ser.close()
+            except OSError:
+                pass
+            self.ser = None
+
+    def _complete(self, job, **result):
+        self.counts["completed"] += 1
+        self.latency.append(time.monotonic() - job.created)
+        job.finish(ok=True, **result)
+
+    def _finish_refresh(self):
+        """Read the deferred "EPD done" ACK; its job is then complete."""
+        job = self.refreshing
+        if job is None:
+            return
+        wait_ack(self.ser, "EPD done")
+        self.refresh_s.append(time.monotonic() - self.refresh_t)
+        self.refreshing = None
+        self._complete(job)
+
+    def _execute(self, job):
+        """Returns the job's result, or None while its refresh runs."""
+        ser = self._serial()
+
+        if job.kind == "clear":
+            self._finish_refresh()
+            t = time.monotonic()
+            cmd_clear(ser)
+            self.refresh_s.append(time.monotonic() - t)
+            return {}
+
+        # Upload during the refresh. Its ACKs and the refresh's are all
+        # 0x06: after cmd_send() exactly one of them is still due.
+        if self.refreshing is not None and self.buffer != job.hash:
+            t = time.monotonic()
+            cmd_send(ser, job.frame)
+            self.upload_s.append(time.monotonic() - t)
+        self._finish_refresh()
+
+        shown, buffer = cmd_hash(ser)
+        self.buffer = buffer
+        if shown == job.hash:
+            self.counts["unchanged"] += 1
+            return {"unchanged": True}
+
+        if buffer != job.hash:
+            t = time.monotonic()
+            cmd_send(ser, job.frame)
+            self.upload_s.append(time.monotonic() - t)
+            _, self.buffer = cmd_hash(ser)
+            if self.buffer != job.hash:
+                raise RuntimeError(f"upload corrupted: MCU has "
+                                   f"{self.buffer:08x}, expected "
+                                   f"{job.hash:08x}")
+
+        # Refresh is the expensive step; don't spend it on a stale frame.
+        if self._newer_pending():
+            raise Superseded
+
+        cmd_write(ser, if_changed=True, wait=False)
+        self.refreshing = job
+        self.refresh_t  = time.monotonic()
+        return None
+
+    def _run(self):
+        while True:
+            job = self._take()
+            try:
+                if job is None:
+                    self._finish_refresh()
+                    continue
+                result = self._execute(job)
+                if result is not None:
+                    self._complete(job, **result)
+            except Superseded:
+                self.counts["coalesced"] += 1
+                job.finish(ok=True, superseded=True)
+            except Exception as e:           # noqa: BLE001 — report to client
+                for failed in {job, self.refreshing} - {None}:
+                    self.counts["failed"] += 1
+                    failed.finish(ok=False, error=str(e))
+                self.refreshing = None
+                self.buffer = None
+                self._drop_serial()          # resync on the next job
+            finally:
+                with self.cond:
+                    self.active = self.refreshing
+
+    def metrics(self):
+        with self.cond:
+            depth = (self.pending is not None) + (self.active is not None)
+        lat = sorted(self.latency)
+        pct = lambda p: round(lat[min(len(lat) - 1, int(p * len(lat)))], 3) \
+            if lat else None
+        mean = lambda d: round(sum(d) / len(d), 3) if d else None
+        return {
+            "port":        self.port,
+            "queue_depth": depth,
+            **{k: self.counts[k] for k in ("submitted", "completed",
+               "coalesced", "unchanged", "failed")},
+            "latency_s":   {"p50": pct(0.50), "p95": pct(0.95),
+                            "max": round(lat[-1], 3) if lat else None},
+            "upload_s":    mean(self.upload_s),
+            "refresh_s":   mean(self.refresh_s),
+        }
+
+
+# ── socket server ─────────────────────────────────────────────────────────────
+class Handler(socketserver.StreamRequestHandler):
+    def handle(self):
+        for line in self.rfile:
+            try:
+                reply = self.server.einkd.request(json.loads(line))
+            except Exception as e:           # noqa: BLE001 — report to client
+                reply = {"ok": False, "error": str(e)}
+            self.wfile.write((json.dumps(reply) + "\n").encode())
+            self.wfile.flush()
+
+
+class Server(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    daemon_threads = True
+
+
+class Daemon:
+    def __init__(self, devices):
+        self.devices = {name: Device(name, port) for name, port in devices}
+        self.started = time.monotonic()
+
+    def _device(self, req):
+        name = req.get("device")
+        if name not in self.devices:
+            raise KeyError(f"unknown device {name!r}")
+        return self.devices[name]
+
+    def request(self, req):
+        op = req.get("op")
+
+        if op == "metrics":
+            return {"ok": True,
+                    "uptime_s": round(time.monotonic() - self.started, 1),
+                    "devices": {n: d.metrics()
+                                for n, d in self.devices.items()}}
+
+        if op == "show":
+            if "file" in req:
+                frame = load_frame(req["file"])
+            else:
+                frame = base64.b64decode(req["data"])
+            if len(frame) != FRAMEBUFFER_SIZE:
+                raise ValueError(f"expected {FRAMEBUFFER_SIZE} bytes, "
+                                 f"got {len(frame)}")
+            job = Job("show", frame)
+        elif op == "clear":
+            job = Job("clear")
+        else:
+            raise ValueError(f"unknown op {op!r}")
+
+        self._device(req).submit(job)
+        if not req.get("wait"):
+            return {"ok": True, "queued": True}
+        job.done.wait()
+        return {**job.result,
+                "latency_s": round(time.monotonic() - job.created, 3)}
+
+
+def serve(args):
+    send.VERBOSE = False
+    devices = []
+    for spec in args.device:
+        name, _, port = spec.partition("=")
+        if not port:
+            sys.exit(f"--device expects NAME=PORT, got {spec!r}")
+        devices.append((name, port))
+
+    if os.path.exists(args.socket):
+        os.unlink(args.socket)
+    server = Server(args.socket, Handler)
+    server.einkd = Daemon(devices)
+    signal.signal(signal.SIGTERM, lambda *_: threading.Thread(
+        target=server.shutdown).start())
+    print(f"einkd: {len(devices)} device(s), listening on {args.socket}",
+          flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.server_close()
+        os.unlink(args.socket)
+
+
+# ── client ────────────────────────────────────────────────────────────────────
+def request(req, path=SOCKET_PATH):
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as s:
+        s.connect(path)
+        s.sendall((json.dumps(req) + "\n").encode())
+        return json.loads(s.makefile().readline())
+
+
+def main():
+    ap = argparse.ArgumentParser(description="e-ink tag daemon")
+    ap.add_argument("--socket", default=SOCKET_PATH)
+    sub = ap.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("serve", help="run the daemon")
+    p.add_argument("--device", action="append", required=True,
+                   metavar="NAME=PORT")
+
+    p = sub.add_parser("show", help="queue a framebuffer file")
+    p.add_argument("device")
+    p.add_argument("file")
+    p.add_argument("--wait", action="store_true")
+
+    p = sub.add_parser("clear", help="queue a clear")
+    p.add_argument("device")
+    p.add_argument("--wait", action="store_true")
+
+    sub.add_parser("metrics", help="print queue depth and latency")
+
+    args = ap.parse_args()
+    if args.command == "serve":
+        serve(args)
+        return
+
+    if args.command == "show":
+        req = {"op": "show", "device": args.device,
+               "file": os.path.abspath(args.file), "wait": args.wait}
+    elif args.command == "clear":
+        req = {"op": "clear", "device": args.device, "wait": args.wait}
+    else:
+        req = {"op": "metrics"}
+
+    reply = request(req, args.socket)
+    print(json.dumps(reply, indent=2))
+    sys.exit(0 if reply.get("ok") else 1)
+
+
+if __name__ == "__main__":
+    main()
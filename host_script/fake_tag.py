@@ -0,0 +1,425 @@
+#!/usr/bin/env python3
+"""
+fake_tag.py — stand-in for the CC2530 tag on a pseudo-terminal
+
+Speaks the same serial protocol as uart_rx.c so host tools can be run
+without hardware:
+
+  python fake_tag.py                    print the pty path and serve it
+  python fake_tag.py --link /tmp/tag0   also symlink the pty to /tmp/tag0
+  python fake_tag.py --count 8 --link /tmp/tag%d
+                                        eight tags, /tmp/tag0 … /tmp/tag7
+  EINK_PORT=/tmp/tag0 python send.py show image.bin
+
+Timing follows the firmware: a refresh blocks for --refresh seconds, and
+the reset/power-on sequence (--init) is only paid when the panel went to
+deep sleep after --idle seconds without an update. --drop makes the tag
+swallow that fraction of commands without replying, to exercise host
+timeouts and retries.
+"""
+
+import argparse
+import os
+import random
+import struct
+import sys
+import threading
+import time
+import tty
+import zlib
+
+import assets
+from send import (FRAMEBUFFER_SIZE, CMD_SEND, CMD_WRITE, CMD_WRITE_CHANGED,
+                  CMD_CLEAR, CMD_HASH, HASH_SHOWN_VALID, HASH_BUFFER_VALID,
+                  CMD_TEXT_MAP, CMD_TEXT_PUT, CMD_TEXT_WRITE,
+                  TEXT_COLS, TEXT_ROWS, TEXT_TALL, TEXT_WIDE, TEXT_INVERSE,
+                  CMD_BACKGROUND, CMD_OVERLAYS, CMD_COMPOSE, ROW_BYTES,
+                  COMPOSE_MAX_OVERLAYS, COMPOSE_POOL_SIZE, ACK, NAK,
+                  CMD_BATCH, BATCH_MAX, BATCH_UPLOAD, BATCH_PATCH, BATCH_CHECK,
+                  BATCH_WRITE, BATCH_WRITE_CHANGED, BATCH_CLEAR, BATCH_TEXT,
+                  BATCH_COMPOSE, BATCH_SLEEP, BATCH_OK, BATCH_UNCHANGED,
+                  BATCH_BAD, BATCH_MISMATCH, BATCH_NOT_RUN, CMD_SPI,
+                  CMD_EPD_SEQ, EPD_SEQ_RAM, seq_split)
+
+CLEAR_FRAME = b"\xff" * FRAMEBUFFER_SIZE   # EPD_Clear() shows white
+
+
+def load_assets():
+    """Fonts and backgrounds as the firmware has them (assets/assets.list)."""
+    compiled = assets.load_list()
+    font = next(a for a in compiled if a["kind"] == assets.KIND_FONT)
+    glyphs = [font["data"][i:i + font["w"]]
+              for i in range(0, len(font["data"]), font["w"])]
+    backgrounds = [CLEAR_FRAME]                 # COMPOSE_BG(id) = id + 1
+    for a in compiled:
+        if a["kind"] != assets.KIND_FRAME:
+            backgrounds.append(None)
+        elif a["enc"] == assets.ENC_PACKBITS:
+            backgrounds.append(assets.unpackbits(a["data"]))
+        else:
+            backgrounds.append(a["data"])
+    return glyphs, backgrounds
+
+
+def compose_render(background, overlays):
+    """Framebuffer the firmware sends for a background + overlays."""
+    fb = bytearray(background)
+    for op, col, w, y, h, data in overlays:
+        for r in range(h):
+            for i in range(w):
+                k, b = (y + r) * ROW_BYTES + col + i, data[r * w + i]
+                fb[k] = (b, fb[k] | b, fb[k] & b, fb[k] ^ b)[op]
+    return bytes(fb)
+
+
+def text_render(attrs, cells, font):
+    """Framebuffer the firmware sends for a tile map (same as text.c)."""
+    stretch = [sum(((n >> i) & 1) * (3 << 2 * i) for i in range(4))
+               for n in range(16)]
+    owner, half = list(range(TEXT_ROWS)), [0] * TEXT_ROWS   # 1 top, 2 bottom
+    for r in range(TEXT_ROWS):
+        if r and half[r - 1] == 1:
+            owner[r], half[r] = r - 1, 2
+        elif attrs[r] & TEXT_TALL and r < TEXT_ROWS - 1:
+            half[r] = 1
+
+    fb = bytearray(FRAMEBUFFER_SIZE)
+    for y in range(FRAMEBUFFER_SIZE // 13):
+        for c in range(13):
+            t  = TEXT_ROWS - 1 - c
+            r  = owner[t]
+            cw = 12 if attrs[r] & TEXT_WIDE else 6
+            cx, gx = y // cw, (y % cw) // (cw // 6)
+            ch = cells[r * TEXT_COLS + cx] if cx < TEXT_COLS else 0x20
+            col = 0
+            if gx < 5 and (ch & 0x7F) >= 0x20:
+                col = font[(ch & 0x7F) - 0x20][gx]
+            if half[t] == 1:
+                col = stretch[col & 0x0F]
+            elif half[t] == 2:
+                col = stretch[col >> 4]
+            if ch & TEXT_INVERSE:
+                col ^= 0xFF
+            fb[y * 13 + c] = col ^ 0xFF
+    return bytes(fb)
+
+
+class FakeTag:
+    def __init__(self, name="tag", refresh=3.0, init=0.3, idle=5.0,
+                 drop=0.0, verbose=False):
+        self.name    = name
+        self.refresh = refresh
+        self.init    = init
+        self.idle    = idle
+        self.drop    = drop
+        self.verbose = verbose
+
+        self.framebuffer = bytearray(FRAMEBUFFER_SIZE)
+        self.shown       = None        # frame on the panel, None = unknown
+        self.last_use    = None        # None = panel in reset / deep sleep
+        self.stats       = {"uploads": 0, "refreshes": 0, "skipped": 0}
+        self.text_attr   = bytearray(TEXT_ROWS)
+        self.text_map    = bytearray(b" " * (TEXT_ROWS * TEXT_COLS))
+        self.font        = None          # loaded on first use
+        self.backgrounds = None
+        self.background  = 0
+        self.overlays    = []
+        self.hash_unknown = False      # firmware keeps no hash of text/composed frames
+        self.sequences   = {}          # CMD_EPD_SEQ overrides, not modelled
+
+        self.master, slave = os.openpty()
+        tty.setraw(slave)              # no echo, no CR/LF translation
+        self.slave_fd = slave
+        self.path     = os.ttyname(slave)
+
+    # ── io ──
+    def _read(self, n):
+        buf = b""
+        while len(buf) < n:
+            chunk = os.read(self.master, n - len(buf))
+            if not chunk:
+                raise EOFError
+            buf += chunk
+        return buf
+
+    def _write(self, data):
+        os.write(self.master, data)
+
+    def _log(self, msg):
+        if self.verbose:
+            print(f"[{self.name}] {msg}", file=sys.stderr)
+
+    # ── panel model ──
+    def _draw(self, frame):
+        now = time.monotonic()
+        if self.last_use is None or now - self.last_use > self.idle:
+            time.sleep(self.init)      # hw reset + booster + power on
+        time.sleep(self.refresh)
+        self.shown    = bytes(frame)
+        self.hash_unknown = False
+        self.last_use = time.monotonic()
+        self.stats["refreshes"] += 1
+
+    def _write_frame(self, only_changed):
+        if only_changed and self.shown == bytes(self.framebuffer):
+            self.stats["skipped"] += 1
+            self._log("frame already shown, skipped")
+            return False
+        self._draw(self.framebuffer)
+        self._log("refreshed")
+        return True
+
+    def _text_draw(self):
+        if self.font is None:
+            self.font, self.backgrounds = load_assets()
+        self._draw(text_render(self.text_attr, self.text_map, self.font))
+        self.hash_unknown = True
+        self._log("tile map drawn")
+
+    def _compose_draw(self):
+        if self.backgrounds is None:
+            self.font, self.backgrounds = load_assets()
+        self._draw(compose_render(self.backgrounds[self.background],
+                                  self.overlays))
+        self.hash_unknown = True
+        self._log("composed frame drawn")
+
+    def _hashes(self):
+        """flags, shown CRC32, buffer CRC32 as in the CMD_HASH reply"""
+        flags  = HASH_BUFFER_VALID
+        shown  = 0
+        if self.shown is not None and not self.hash_unknown:
+            flags |= HASH_SHOWN_VALID
+            shown  = zlib.crc32(self.shown)
+        return struct.pack("<BII", flags, shown, zlib.crc32(self.framebuffer))
+
+    def _batch(self):
+        """CMD_BATCH: read and run the operations, one status record."""
+        count, left = struct.unpack("<BH", self._read(3))
+        if count > BATCH_MAX:
+            self._read(left)
+            self._write(bytes([NAK]))
+            return
+        body = self._read(left)      # the rest is read even if not parsed
+
+        def take(n):
+            nonlocal body
+            if n > len(body):
+                raise ValueError("operation runs past the batch length")
+            data, body = body[:n], body[n:]
+            return data
+
+        results, failed = [], False
+        for _ in range(count):
+            try:
+                op = take(1)[0]
+                args = take(4) if op in (BATCH_PATCH, BATCH_CHECK) else b""
+                if op == BATCH_UPLOAD:
+                    data = take(FRAMEBUFFER_SIZE)
+                elif op == BATCH_PATCH:
+                    data = take(struct.unpack("<HH", args)[1])
+            except ValueError:
+                op = None
+            result = BATCH_NOT_RUN if failed else BATCH_OK
+            if op == BATCH_UPLOAD:
+                if not failed:
+                    self.framebuffer[:] = data
+                    self.stats["uploads"] += 1
+            elif op == BATCH_PATCH:
+                offset, n = struct.unpack("<HH", args)
+                if not failed:
+                    if offset + n > FRAMEBUFFER_SIZE:
+                        result = BATCH_BAD
+                    else:
+                        self.framebuffer[offset:offset + n] = data
+            elif op == BATCH_CHECK:
+                crc = struct.unpack("<I", args)[0]
+                if not failed and crc != zlib.crc32(self.framebuffer):
+                    result = BATCH_MISMATCH
+            elif op not in (BATCH_WRITE, BATCH_WRITE_CHANGED, BATCH_CLEAR,
+                            BATCH_TEXT, BATCH_COMPOSE, BATCH_SLEEP):
+                # unknown length or short: the rest of the batch is lost
+                results += [BATCH_BAD] * (count - len(results))
+                break
+            elif failed:
+                pass
+            elif op in (BATCH_WRITE, BATCH_WRITE_CHANGED):
+                if not self._write_frame(op == BATCH_WRITE_CHANGED):
+                    result = BATCH_UNCHANGED
+            elif op == BATCH_CLEAR:
+                self._draw(CLEAR_FRAME)
+            elif op == BATCH_TEXT:
+                self._text_draw()
+            elif op == BATCH_COMPOSE:
+                self._compose_draw()
+            elif op == BATCH_SLEEP:
+                self.last_use = None
+            failed |= result in (BATCH_BAD, BATCH_MISMATCH)
+            results.append(result)
+        self._write(bytes([ACK, count]) + bytes(results) + self._hashes())
+        self._log(f"batch of {count}: {results}")
+
+    # ── protocol ──
+    def handle(self, cmd):
+        if cmd == CMD_SEND:
+            self._write(bytes([ACK]))
+            self.framebuffer[:] = self._read(FRAMEBUFFER_SIZE)
+            self.stats["uploads"] += 1
+            self._write(bytes([ACK]))
+            self._log("framebuffer received")
+
+        elif cmd in (CMD_WRITE, CMD_WRITE_CHANGED):
+            self._write(bytes([ACK]))
+            self._write_frame(cmd == CMD_WRITE_CHANGED)
+            self._write(bytes([ACK]))
+
+        elif cmd == CMD_CLEAR:
+            self._write(bytes([ACK]))
+            self._draw(CLEAR_FRAME)
+            self._write(bytes([ACK]))
+            self._log("cleared")
+
+        elif cmd == CMD_TEXT_MAP:
+            self._write(bytes([ACK]))
+            self.text_attr[:] = self._read(TEXT_ROWS)
+            self.text_map[:]  = self._read(TEXT_ROWS * TEXT_COLS)
+            self._write(bytes([ACK]))
+            self._log("tile map received")
+
+        elif cmd == CMD_TEXT_PUT:
+            self._write(bytes([ACK]))
+            row, col, attr, n = self._read(4)
+            data = self._read(n)
+            if row < TEXT_ROWS:
+                self.text_attr[row] = attr
+                for i, b in enumerate(data):
+                    if col + i < TEXT_COLS:
+                        self.text_map[row * TEXT_COLS + col + i] = b
+            self._write(bytes([ACK]))
+
+        elif cmd == CMD_TEXT_WRITE:
+            self._write(bytes([ACK]))
+            self._text_draw()
+            self._write(bytes([ACK]))
+
+        elif cmd == CMD_BACKGROUND:
+            index = self._read(1)[0]
+            if self.font is None:
+                self.font, self.backgrounds = load_assets()
+            ok = index < len(self.backgrounds) and \
+                self.backgrounds[index] is not None
+            if ok:
+                self.background = index
+            self._write(bytes([ACK if ok else NAK]))
+
+        elif cmd == CMD_OVERLAYS:
+            self._write(bytes([ACK]))
+            self.overlays, used, ok = [], 0, True
+            for _ in range(self._read(1)[0]):
+                op, col, w, y, h = self._read(5)
+                data = self._read(w * h)
+                if (len(self.overlays) < COMPOSE_MAX_OVERLAYS and op < 4 and
+                        w and h and col + w <= ROW_BYTES and y + h <= 212 and
+                        used + w * h <= COMPOSE_POOL_SIZE):
+                    self.overlays.append((op, col, w, y, h, data))
+                    used += w * h
+                else:
+                    ok = False
+            self._write(bytes([ACK if ok else NAK]))
+            self._log(f"{len(self.overlays)} overlay(s), {used} bytes")
+
+        elif cmd == CMD_COMPOSE:
+            self._write(bytes([ACK]))
+            self._compose_draw()
+            self._write(bytes([ACK]))
+
+        elif cmd == CMD_HASH:
+            self._write(bytes([ACK]) + self._hashes())
+
+        elif cmd == CMD_BATCH:
+            self._batch()
+
+        elif cmd == CMD_SPI:
+            # calibrated to the 4 MHz maximum, UC8151 revision and PON
+            self._read(1)
+            self._write(bytes([ACK, 1, 3]) + struct.pack("<HB", 4000, 0x0F) +
+                        b"\x0a\x01\x02\x0c\x05")
+
+        elif cmd == CMD_EPD_SEQ:
+            n = struct.unpack("<H", self._read(2))[0]
+            if n > EPD_SEQ_RAM:
+                self._write(bytes([NAK]))
+                return
+            self._write(bytes([ACK]))
+            try:
+                self.sequences = seq_split(self._read(n))
+                self._write(bytes([ACK]))
+                self._log(f"sequences replaced: {sorted(self.sequences)}")
+            except ValueError as e:
+                self.sequences = {}
+                self._write(bytes([NAK]))
+                self._log(f"sequences rejected: {e}")
+
+        else:
+            self._write(bytes([NAK]))
+            self._log(f"unknown command 0x{cmd:02X}")
+
+    def serve(self):
+        try:
+            while True:
+                cmd = self._read(1)[0]
+                if random.random() < self.drop:
+                    self._log(f"dropped command 0x{cmd:02X}")
+                    continue
+                self.handle(cmd)
+        except (EOFError, OSError):
+            pass
+
+    def start(self):
+        t = threading.Thread(target=self.serve, daemon=True)
+        t.start()
+        return t
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("--link", help="symlink the pty to this path "
+                    "(with --count, a pattern such as /tmp/tag%%d)")
+    ap.add_argument("--count", type=int, default=1,
+                    help="number of tags to simulate (default 1)")
+    ap.add_argument("--refresh", type=float, default=3.0,
+                    help="seconds per panel refresh (default 3.0)")
+    ap.add_argument("--init", type=float, default=0.3,
+                    help="seconds for reset + power on after deep sleep")
+    ap.add_argument("--idle", type=float, default=5.0,
+                    help="idle seconds before the panel deep sleeps")
+    ap.add_argument("--drop", type=float, default=0.0,
+                    help="fraction of commands to ignore (default 0)")
+    ap.add_argument("-v", "--verbose", action="store_true")
+    args = ap.parse_args()
+
+    links = []
+    for i in range(args.count):
+        tag = FakeTag(name=f"tag{i}", refresh=args.refresh, init=args.init,
+                      idle=args.idle, drop=args.drop, verbose=args.verbose)
+        if args.link:
+            link = args.link % i if "%" in args.link else args.link
+            if os.path.lexists(link):
+                os.unlink(link)
+            os.symlink(tag.path, link)
+            links.append(link)
+        print(tag.path, flush=True)
+        tag.start()
+
+    try:
+        threading.Event().wait()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        for link in links:
+            if os.path.islink(link):
+                os.unlink(link)
+
+
+if __name__ == "__main__":
+    main()
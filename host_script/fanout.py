@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+fanout.py — update many tags in parallel from a manifest
+
+  python fanout.py manifest.json [--concurrency 16] [--retries 2]
+
+Manifest (paths relative to the manifest file):
+  {"devices": [
+      {"id": "aisle3-017", "port": "/dev/ttyACM1", "image": "017.bin"},
+      {"id": "aisle3-018", "port": "/dev/ttyACM2", "image": "018.png"}
+  ]}
+
+Images other than .bin are converted with convert.py (cached).
+
+Each tag is driven by its own worker thread; a refresh is seconds of the
+host waiting on BUSY, so N tags finish in roughly the time of one as long
+as --concurrency allows it. Frames a tag already shows are skipped via
+CMD_HASH. A failed device is retried with a fresh serial connection, and
+the run ends with a throughput/failure summary (--json for tooling).
+Exit status is 1 if any device failed.
+"""
+
+import argparse
+import json
+import os
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor, as_completed
+
+import send
+from send import FRAMEBUFFER_SIZE, open_serial, cmd_show, load_frame
+
+
+def load_manifest(path):
+    with open(path) as f:
+        manifest = json.load(f)
+    base = os.path.dirname(os.path.abspath(path))
+    devices = manifest["devices"] if isinstance(manifest, dict) else manifest
+    for d in devices:
+        for key in ("id", "port", "image"):
+            if key not in d:
+                raise ValueError(f"manifest entry {d!r} has no {key!r}")
+        d["image"] = os.path.join(base, d["image"])
+    return devices
+
+
+def update(dev, retries, timeout, settle):
+    """Show dev's image, retrying on errors. Never raises."""
+    result = {"id": dev["id"], "port": dev["port"], "ok": False,
+              "attempts": 0, "refreshed": False, "uploaded": False,
+              "error": None}
+    start = time.monotonic()
+    try:
+        frame = load_frame(dev["image"])
+        if len(frame) != FRAMEBUFFER_SIZE:
+            raise ValueError(f"{dev['image']}: expected {FRAMEBUFFER_SIZE} "
+                             f"bytes, got {len(frame)}")
+    except (OSError, ValueError) as e:
+        result["error"] = str(e)          # retrying won't help
+        return result
+
+    for attempt in range(1, retries + 2):
+        result["attempts"] = attempt
+        try:
+            with open_serial(dev["port"]) as ser:
+                ser.timeout = timeout
+                time.sleep(settle)        # let CDC enumerate
+                ser.reset_input_buffer()
+                result["refreshed"], result["uploaded"] = cmd_show(ser, frame)
+            result["ok"], result["error"] = True, None
+            break
+        except Exception as e:            # noqa: BLE001 — recorded per device
+            result["error"] = f"{type(e).__name__}: {e}"
+            time.sleep(min(0.5 * attempt, 2.0))
+    result["seconds"] = round(time.monotonic() - start, 3)
+    return result
+
+
+def summarize(results, wall):
+    ok      = [r for r in results if r["ok"]]
+    failed  = [r for r in results if not r["ok"]]
+    drawn   = [r for r in ok if r["refreshed"]]
+    sent    = sum(FRAMEBUFFER_SIZE for r in ok if r["uploaded"])
+    secs    = sorted(r.get("seconds", 0.0) for r in ok)
+    return {
+        "devices":      len(results),
+        "ok":           len(ok),
+        "refreshed":    len(drawn),
+        "unchanged":    len(ok) - len(drawn),
+        "failed":       len(failed),
+        "retried":      sum(r["attempts"] > 1 for r in results),
+        "wall_s":       round(wall, 3),
+        "updates_per_s": round(len(ok) / wall, 2) if wall else None,
+        "uploaded":     sum(r["uploaded"] for r in ok),
+        "upload_kib_per_s": round(sent / 1024 / wall, 1) if wall else None,
+        "device_s":     {"mean": round(sum(secs) / len(secs), 3),
+                         "max": secs[-1]} if secs else None,
+        "failures":     {r["id"]: r["error"] for r in failed},
+    }
+
+
+def main():
+    ap = argparse.ArgumentParser(description="parallel multi-tag update")
+    ap.add_argument("manifest")
+    ap.add_argument("--concurrency", type=int, default=16,
+                    help="max devices in flight (default 16)")
+    ap.add_argument("--retries", type=int, default=2,
+                    help="retries per device after the first attempt")
+    ap.add_argument("--timeout", type=float, default=send.ACK_TIMEOUT,
+                    help="seconds to wait for each ACK")
+    ap.add_argument("--settle", type=float, default=0.5,
+                    help="seconds to wait after opening a port")
+    ap.add_argument("--json", action="store_true",
+                    help="print the full report as JSON")
+    args = ap.parse_args()
+
+    send.VERBOSE = False
+    devices = load_manifest(args.manifest)
+
+    start   = time.monotonic()
+    results = []
+    with ThreadPoolExecutor(max_workers=args.concurrency) as pool:
+        futures = [pool.submit(update, d, args.retries, args.timeout,
+                               args.settle) for d in devices]
+        for fut in as_completed(futures):
+            r = fut.result()
+            results.append(r)
+            if not args.json:
+                state = ("ok" if r["refreshed"] else "unchanged") \
+                    if r["ok"] else f"FAILED ({r['error']})"
+                print(f"  {r['id']:<16} {state}  attempts={r['attempts']}")
+    summary = summarize(results, time.monotonic() - start)
+
+    if args.json:
+        print(json.dumps({"summary": summary, "devices": results}, indent=2))
+    else:
+        print(f"\n{summary['ok']}/{summary['devices']} ok "
+              f"({summary['refreshed']} refreshed, {summary['unchanged']} "
+              f"unchanged, {summary['uploaded']} uploaded), "
+              f"{summary['failed']} failed, "
+              f"{summary['retried']} retried")
+        print(f"wall {summary['wall_s']} s, {summary['updates_per_s']} "
+              f"updates/s, {summary['upload_kib_per_s']} KiB/s uploaded")
+        for dev_id, err in summary["failures"].items():
+            print(f"  FAILED {dev_id}: {err}")
+
+    sys.exit(1 if summary["failed"] else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+flash.py — program the application through the serial bootloader
+
+  python flash.py out/firmware-app.ihx      flash changed pages, then run it
+  python flash.py out/firmware-app.ihx --no-run
+  python flash.py --info                    print bootloader info
+
+One-time setup: flash out/boot.bin with CCLib (see README), then
+`make app` builds the application linked at BOOT_APP_BASE
+(`make app BANKED=1` for a banked one, mapped to flash by banks.py).
+
+If the application is running, it is asked to reset into the bootloader
+(CMD_BOOTLOADER, UART only: the firmware NAKs it on the radio link).
+The CRC32 of every application page is compared with the image and only
+differing pages are sent; the bootloader verifies each page after
+writing and the whole image before marking it bootable.
+
+Bootloader protocol (boot.h):
+  'I'                         → ACK, version, app base u16, pages, valid
+  'P' page                    → ACK, CRC32
+  'W' page → ACK, 2048 bytes + CRC32 → ACK | NAK
+  'F' length u32 + CRC32      → ACK | NAK
+  'G'                         → ACK, reset into the application
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+import send
+from banks import load_ihx, physical
+from send import open_serial, PORT
+
+PAGE_SIZE     = 2048
+CMD_BOOT      = 0x42   # application: reset into the bootloader
+BOOT_INFO     = 0x49
+BOOT_CRC      = 0x50
+BOOT_WRITE    = 0x57
+BOOT_FINISH   = 0x46
+BOOT_GO       = 0x47
+ACK, NAK      = 0x06, 0x15
+
+
+# ── image ─────────────────────────────────────────────────────────────────────
+def load_image(path, base):
+    """Flat application image from base, padded to whole 0xFF pages."""
+    if path.endswith(".bin"):
+        with open(path, "rb") as f:
+            data = f.read()[base:]
+    else:
+        mem = {a: b for a, b in physical(load_ihx(path)).items() if a >= base}
+        if not mem:
+            raise ValueError(f"{path}: nothing at or above 0x{base:04x} — "
+                             "was it linked with `make app`?")
+        data = bytearray(b"\xff" * (max(mem) + 1 - base))
+        for a, b in mem.items():
+            data[a - base] = b
+    pad = -len(data) % PAGE_SIZE
+    return bytes(data) + b"\xff" * pad
+
+
+# ── bootloader link ───────────────────────────────────────────────────────────
+def expect(ser, label):
+    b = ser.read(1)
+    if not b:
+        raise TimeoutError(f"no reply ({label})")
+    if b[0] != ACK:
+        raise RuntimeError(f"{label}: got 0x{b[0]:02x}")
+
+
+def boot_info(ser):
+    ser.write(bytes([BOOT_INFO]))
+    reply = ser.read(6)
+    if len(reply) != 6 or reply[0] != ACK:
+        return None
+    version, base, pages, valid = struct.unpack("<BHBB", reply[1:])
+    return {"version": version, "base": base, "pages": pages,
+            "valid": bool(valid)}
+
+
+def enter_bootloader(ser):
+    info = boot_info(ser)
+    if info:
+        return info
+    ser.reset_input_buffer()
+    ser.write(bytes([CMD_BOOT]))   # application ACKs, then resets
+    time.sleep(0.3)
+    ser.reset_input_buffer()
+    info = boot_info(ser)
+    if not info:
+        raise RuntimeError("no bootloader answering")
+    return info
+
+
+def page_crc(ser, page):
+    ser.write(bytes([BOOT_CRC, page]))
+    expect(ser, f"crc page {page}")
+    return struct.unpack("<I", ser.read(4))[0]
+
+
+def write_page(ser, page, data):
+    ser.write(bytes([BOOT_WRITE, page]))
+    expect(ser, f"write page {page}")
+    ser.write(data + struct.pack("<I", zlib.crc32(data)))
+    ser.flush()
+    expect(ser, f"verify page {page}")
+
+
+def flash(ser, image, base, run=True):
+    first = base // PAGE_SIZE
+    pages = len(image) // PAGE_SIZE
+    start = time.monotonic()
+    sent  = 0
+    for i in range(pages):
+        data = image[i * PAGE_SIZE:(i + 1) * PAGE_SIZE]
+        if page_crc(ser, first + i) == zlib.crc32(data):
+            continue
+        for attempt in range(3):
+            try:
+                write_page(ser, first + i, data)
+                break
+            except RuntimeError:
+                if attempt == 2:
+                    raise
+        sent += 1
+        print(f"  page {first + i:3d} @ 0x{(first + i) * PAGE_SIZE:05x} written")
+
+    ser.write(bytes([BOOT_FINISH]) +
+              struct.pack("<II", len(image), zlib.crc32(image)))
+    expect(ser, "image verify")
+    print(f"[flash] {sent}/{pages} pages written in "
+          f"{time.monotonic() - start:.2f} s, image crc {zlib.crc32(image):08x}")
+
+    if run:
+        ser.write(bytes([BOOT_GO]))
+        expect(ser, "go")
+        print("[flash] application started")
+
+
+def main():
+    ap = argparse.ArgumentParser(description="serial bootloader client")
+    ap.add_argument("image", nargs="?", help=".ihx (or flat .bin) application")
+    ap.add_argument("--port", default=PORT)
+    ap.add_argument("--info", action="store_true")
+    ap.add_argument("--no-run", action="store_true",
+                    help="stay in the bootloader after flashing")
+    args = ap.parse_args()
+    if not args.info and not args.image:
+        ap.error("image required")
+
+    send.VERBOSE = False
+    with open_serial(args.port) as ser:
+        ser.timeout = 2
+        time.sleep(0.5)   # let CDC enumerate
+        ser.reset_input_buffer()
+        info = enter_bootloader(ser)
+        print(f"[flash] bootloader v{info['version']}, app at "
+              f"0x{info['base']:04x}, image {'valid' if info['valid'] else 'INVALID'}")
+        if args.info:
+            return
+        image = load_image(args.image, info["base"])
+        flash(ser, image, info["base"], run=not args.no_run)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except (RuntimeError, TimeoutError, ValueError) as e:
+        sys.exit(f"flash.py: {e}")
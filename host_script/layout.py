@@ -0,0 +1,496 @@
+#!/usr/bin/env python3
+"""
+layout.py — render label templates straight into framebuffers
+
+  python layout.py labels.json -o out/             out/<id>.bin, out/hashes.json
+  python layout.py labels.json -o out/ --changed   only frames that changed
+  python layout.py labels.json -o out/ --preview   also out/<id>.png
+  python layout.py labels.json -o out/ --show 17   render label 17, put it on
+                                                   the tag (send.cmd_update)
+  python layout.py labels.json --bench 5000        labels per second
+
+labels.json:
+  {"templates": {"shelf": {
+      "background": "shelf.png",
+      "elements": [
+        {"type": "rect",    "x": 0, "y": 0, "w": 212, "h": 17},
+        {"type": "text",    "text": "{name}", "x": 3, "y": 3, "scale": 2,
+                            "color": "white"},
+        {"type": "text",    "text": "{price:.2f}", "x": 0, "y": 20, "w": 208,
+                            "align": "right", "font": "Lato-Bold.ttf", "size": 44},
+        {"type": "text",    "text": "{unit_price} / kg", "x": 3, "y": 60},
+        {"type": "barcode", "value": "{ean}", "x": 3, "y": 72, "h": 24,
+                            "digits": true}]}},
+   "labels": [
+      {"id": "17", "template": "shelf", "name": "APPLES", "price": 1.99,
+       "unit_price": "3.98", "ean": "400638133393", "port": "/dev/ttyACM1"}]}
+
+Coordinates are in the label as it is read: 212x104, origin top left
+(104x212 with "portrait": true in the template, like convert.py). Text
+and barcode values are Python format strings over the label's fields;
+elements without fields, the background (any image, scaled and dithered
+by convert.py) and "image" elements with a fixed "src" are drawn once
+into the template's static layer. A label then costs a copy of that
+layer, the field elements and the packing.
+
+  text     "text", "x", "y" (top of the line), "w" (box, to the right
+           edge by default), "align" left|center|right, "font" "5x7"
+           (the firmware's assets/font5x7.png, default) with "scale", or
+           a TrueType/OpenType file with "size". Text is clipped to the
+           box and reported.
+  barcode  EAN-13: "value" of 12 digits (check digit added) or 13,
+           "module" pixels per bar unit, "h", "digits" to print them
+  rect     "x", "y", "w", "h", filled
+  image    "src" file, "x", "y", "w", "h"
+  "color": "white" draws any of them white (on a rect or a background).
+
+Caches: glyph bitmaps per font, rendered text runs and barcodes per
+value (LRU), images per file and size, static layers per template.
+
+Every frame's CRC32 is the hash CMD_HASH reports (send.frame_hash).
+hashes.json in the output directory keeps them between runs: --changed
+skips labels whose frame is unchanged, and the rest go to changed.txt.
+Labels with a "port" are listed in manifest.json for fanout.py, with
+--changed only those that changed.
+
+Requires: numpy; Pillow for TrueType fonts and images
+"""
+
+import argparse
+import json
+import os
+import string
+import sys
+import time
+import zlib
+from functools import lru_cache
+
+import numpy as np
+
+from assets import font_from_png
+
+HERE             = os.path.dirname(os.path.abspath(__file__))
+FONT_5X7         = os.path.join(HERE, "..", "assets", "font5x7.png")
+FRAME_W, FRAME_H = 104, 212          # panel scan layout
+FRAME_SIZE       = FRAME_W * FRAME_H // 8
+RUN_CACHE        = 16384             # text runs and barcodes kept
+
+
+# ── fonts ─────────────────────────────────────────────────────────────────────
+class BitmapFont:
+    """The firmware's glyph sheet (assets.py font:), scaled by an integer.
+    All 96 glyphs are rasterised up front, a run is one fancy index."""
+
+    def __init__(self, path, scale=1):
+        gw, gh, cols = font_from_png(path)
+        cols = np.frombuffer(cols, dtype=np.uint8).reshape(96, gw)
+        bits = (cols[:, None, :] >> np.arange(gh)[None, :, None]) & 1
+        cell = np.zeros((96, gh, gw + 1), dtype=bool)       # + spacing
+        cell[:, :, :gw] = bits
+        self.glyphs = cell.repeat(scale, axis=1).repeat(scale, axis=2)
+        self.height = gh * scale
+        self.space  = scale
+
+    def run(self, text):
+        idx = [ord(c) - 32 if 32 <= ord(c) < 128 else ord("?") - 32
+               for c in text]
+        n, h, w = len(idx), self.height, self.glyphs.shape[2]
+        if not n:
+            return np.zeros((h, 0), dtype=bool)
+        run = self.glyphs[idx].transpose(1, 0, 2).reshape(h, n * w)
+        return run[:, :-self.space]
+
+
+class TrueTypeFont:
+    """A Pillow font, glyphs rasterised 1-bit on first use. Runs are laid
+    out on the advance widths, without kerning."""
+
+    def __init__(self, path, size):
+        from PIL import ImageFont
+        self.font = ImageFont.truetype(path, size)
+        ascent, descent = self.font.getmetrics()
+        self.height = ascent + descent
+        self.glyphs = {}
+
+    def glyph(self, ch):
+        g = self.glyphs.get(ch)
+        if g is None:
+            from PIL import Image, ImageDraw
+            left, top, right, bottom = self.font.getbbox(ch, mode="1")
+            bitmap = np.zeros((0, 0), dtype=bool)
+            if right > left and bottom > top:
+                img = Image.new("1", (right - left, bottom - top), 0)
+                ImageDraw.Draw(img).text((-left, -top), ch, font=self.font,
+                                         fill=1)
+                bitmap = np.asarray(img, dtype=bool)
+            g = self.glyphs[ch] = (bitmap, left, top,
+                                   self.font.getlength(ch, mode="1"))
+        return g
+
+    def run(self, text):
+        pen, placed = 0.0, []
+        for ch in text:
+            bitmap, left, top, advance = self.glyph(ch)
+            placed.append((round(pen) + left, top, bitmap))
+            pen += advance
+        width = max([round(pen)] + [x + b.shape[1] for x, _, b in placed])
+        run = np.zeros((self.height, max(width, 0)), dtype=bool)
+        for x, y, bitmap in placed:
+            blit(run, bitmap, x, y)
+        return run
+
+
+@lru_cache(maxsize=RUN_CACHE)
+def text_run(font, text):
+    run = font.run(text)
+    run.setflags(write=False)
+    return run
+
+
+# ── barcodes ──────────────────────────────────────────────────────────────────
+EAN_L = ["0001101", "0011001", "0010011", "0111101", "0100011",
+         "0110001", "0101111", "0111011", "0110111", "0001011"]
+EAN_G = [l.translate(str.maketrans("01", "10"))[::-1] for l in EAN_L]
+EAN_R = [l.translate(str.maketrans("01", "10")) for l in EAN_L]
+EAN_PARITY = ["LLLLLL", "LLGLGG", "LLGGLG", "LLGGGL", "LGLLGG",
+              "LGGLLG", "LGGGLL", "LGLGLG", "LGLGGL", "LGGLGL"]
+
+
+def ean13_check(digits):
+    """Check digit for the first 12 digits."""
+    s = sum(int(c) * (3 if i % 2 else 1) for i, c in enumerate(digits[:12]))
+    return str(-s % 10)
+
+
+def ean13(value):
+    """→ (13 digits, 95 modules as a '0'/'1' string)."""
+    digits = str(value)
+    if not digits.isdigit() or len(digits) not in (12, 13):
+        raise ValueError(f"EAN-13 needs 12 or 13 digits, got {value!r}")
+    if len(digits) == 12:
+        digits += ean13_check(digits)
+    elif digits[12] != ean13_check(digits):
+        raise ValueError(f"EAN-13 {digits}: check digit should be "
+                         f"{ean13_check(digits)}")
+    parity = EAN_PARITY[int(digits[0])]
+    bars = "101"
+    for p, c in zip(parity, digits[1:7]):
+        bars += (EAN_L if p == "L" else EAN_G)[int(c)]
+    bars += "01010"
+    for c in digits[7:]:
+        bars += EAN_R[int(c)]
+    return digits, bars + "101"
+
+
+@lru_cache(maxsize=RUN_CACHE)
+def barcode(value, module, height, digits):
+    code, bars = ean13(value)
+    row = np.repeat(np.frombuffer(bars.encode(), dtype=np.uint8) == ord("1"),
+                    module)
+    img = np.repeat(row[None, :], height, axis=0)
+    if digits:
+        text = text_run(font("5x7", 1), code)
+        img = np.vstack([img, np.zeros((text.shape[0] + 1, img.shape[1]),
+                                       dtype=bool)])
+        blit(img, text, (img.shape[1] - text.shape[1]) // 2, height + 1)
+    img.setflags(write=False)
+    return img
+
+
+# ── drawing ───────────────────────────────────────────────────────────────────
+_fonts = {}
+
+
+def font(name, size, base_dir="."):
+    """"5x7" at scale size, or a font file at size points."""
+    key = (name, size)
+    if key not in _fonts:
+        if name == "5x7":
+            _fonts[key] = BitmapFont(FONT_5X7, size)
+        else:
+            path = os.path.join(base_dir, name)
+            _fonts[key] = TrueTypeFont(path if os.path.exists(path) else name,
+                                       size)
+    return _fonts[key]
+
+
+@lru_cache(maxsize=256)
+def image(path, w, h):
+    """Image file scaled into w x h and dithered, True = ink."""
+    from PIL import Image
+    from convert import fit_image, dither
+    with Image.open(path) as img:
+        gray = np.asarray(fit_image(img, (w, h), "contain"))
+    ink = ~dither(gray, "fs")
+    ink.setflags(write=False)
+    return ink
+
+
+def blit(canvas, bitmap, x, y, white=False):
+    """OR bitmap into canvas at x, y (AND NOT for white), clipped."""
+    h, w = bitmap.shape
+    x0, y0 = max(x, 0), max(y, 0)
+    x1, y1 = min(x + w, canvas.shape[1]), min(y + h, canvas.shape[0])
+    if x0 >= x1 or y0 >= y1:
+        return
+    src = bitmap[y0 - y:y1 - y, x0 - x:x1 - x]
+    if white:
+        canvas[y0:y1, x0:x1] &= ~src
+    else:
+        canvas[y0:y1, x0:x1] |= src
+
+
+def fields(fmt):
+    return [f for _, f, _, _ in string.Formatter().parse(fmt) if f is not None]
+
+
+class Element:
+    def __init__(self, spec, base_dir, size):
+        self.spec  = spec
+        self.type  = spec.get("type", "text")
+        self.x     = int(spec.get("x", 0))
+        self.y     = int(spec.get("y", 0))
+        self.white = spec.get("color", "black") == "white"
+        self.fmt   = None
+        if self.type == "text":
+            self.fmt   = str(spec.get("text", ""))
+            self.w     = int(spec.get("w", size[0] - self.x))
+            self.align = spec.get("align", "left")
+            name = spec.get("font", "5x7")
+            self.font = font(name, int(spec.get("scale" if name == "5x7"
+                                                else "size", 1 if name == "5x7"
+                                                else 16)), base_dir)
+        elif self.type == "barcode":
+            self.fmt    = str(spec["value"])
+            self.module = int(spec.get("module", 2))
+            self.h      = int(spec.get("h", 30))
+            self.digits = bool(spec.get("digits", False))
+        elif self.type == "rect":
+            self.bitmap = np.ones((int(spec["h"]), int(spec["w"])), dtype=bool)
+        elif self.type == "image":
+            self.bitmap = image(os.path.join(base_dir, spec["src"]),
+                                int(spec["w"]), int(spec["h"]))
+        else:
+            raise ValueError(f"unknown element type {self.type!r}")
+        self.fields = fields(self.fmt) if self.fmt else []
+
+    def value(self, label):
+        try:
+            return self.fmt.format_map(label)
+        except KeyError as e:
+            raise ValueError(f"label {label.get('id')!r} has no field "
+                             f"{e.args[0]!r}") from None
+
+    def draw(self, canvas, label):
+        """Returns the pixels of text cut off by its box."""
+        if self.type == "text":
+            run = text_run(self.font, self.value(label))
+            over = run.shape[1] - self.w
+            if over > 0:
+                run = run[:, :self.w]
+            x = self.x
+            if self.align == "center":
+                x += max(0, -over) // 2
+            elif self.align == "right":
+                x += max(0, -over)
+            blit(canvas, run, x, self.y, self.white)
+            return max(0, over)
+        if self.type == "barcode":
+            bitmap = barcode(self.value(label), self.module, self.h,
+                             self.digits)
+        else:
+            bitmap = self.bitmap
+        blit(canvas, bitmap, self.x, self.y, self.white)
+        return 0
+
+
+class Template:
+    """Static layer drawn once; the field elements per label on a copy."""
+
+    def __init__(self, spec, base_dir):
+        self.portrait = bool(spec.get("portrait", False))
+        self.size     = (FRAME_W, FRAME_H) if self.portrait else (FRAME_H, FRAME_W)
+        w, h = self.size
+        self.layer = np.zeros((h, w), dtype=bool)
+        if "background" in spec:
+            blit(self.layer, image(os.path.join(base_dir, spec["background"]),
+                                   w, h), 0, 0)
+        self.elements = []
+        for e in spec.get("elements", []):
+            el = Element(e, base_dir, self.size)
+            if el.fields:
+                self.elements.append(el)
+            else:
+                el.draw(self.layer, {})
+        self.layer.setflags(write=False)
+
+    def render(self, label):
+        """→ (label-oriented ink array, pixels of clipped text)."""
+        canvas = self.layer.copy()
+        clipped = sum(el.draw(canvas, label) for el in self.elements)
+        return canvas, clipped
+
+    def frame(self, label):
+        """→ (framebuffer bytes, pixels of clipped text)."""
+        canvas, clipped = self.render(label)
+        white = ~canvas
+        panel = white if self.portrait else np.rot90(white, -1)   # convert.to_panel
+        return np.packbits(panel).tobytes(), clipped
+
+
+def load_templates(doc, base_dir):
+    specs = doc.get("templates") or {"default": doc.get("template", {})}
+    return {name: Template(spec, base_dir) for name, spec in specs.items()}
+
+
+def template_of(templates, label):
+    name = label.get("template")
+    if name is None and len(templates) == 1:
+        return next(iter(templates.values()))
+    if name not in templates:
+        raise ValueError(f"label {label.get('id')!r}: no template {name!r}")
+    return templates[name]
+
+
+def frame_hash(framebuffer):
+    """send.frame_hash, without pyserial."""
+    return zlib.crc32(framebuffer) & 0xFFFFFFFF
+
+
+# ── output ────────────────────────────────────────────────────────────────────
+def label_id(label):
+    lid = str(label.get("id", ""))
+    if not lid or "/" in lid or lid.startswith("."):
+        raise ValueError(f"label needs an \"id\" usable as a file name, "
+                         f"got {lid!r}")
+    return lid
+
+
+def write_preview(path, canvas):
+    from PIL import Image
+    Image.fromarray(np.where(canvas, 0, 255).astype(np.uint8)).save(path)
+
+
+def read_hashes(out_dir):
+    try:
+        with open(os.path.join(out_dir, "hashes.json")) as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return {}
+
+
+def render_all(templates, labels, out_dir, changed_only, preview):
+    previous = read_hashes(out_dir)
+    hashes, changed, clipped, manifest = {}, [], [], []
+    start = time.monotonic()
+
+    for label in labels:
+        lid = label_id(label)
+        tpl = template_of(templates, label)
+        frame, clip = tpl.frame(label)
+        h = f"{frame_hash(frame):08x}"
+        hashes[lid] = h
+        if clip:
+            clipped.append(f"{lid} ({clip} px)")
+        path = os.path.join(out_dir, lid + ".bin")
+        if changed_only and previous.get(lid) == h and os.path.exists(path):
+            continue
+        with open(path, "wb") as f:
+            f.write(frame)
+        if preview:
+            write_preview(os.path.join(out_dir, lid + ".png"),
+                          tpl.render(label)[0])
+        changed.append(lid)
+        if "port" in label:
+            manifest.append({"id": lid, "port": label["port"],
+                             "image": lid + ".bin"})
+
+    elapsed = time.monotonic() - start
+    with open(os.path.join(out_dir, "hashes.json"), "w") as f:
+        json.dump(hashes, f, indent=0, sort_keys=True)
+    with open(os.path.join(out_dir, "changed.txt"), "w") as f:
+        f.write("".join(lid + "\n" for lid in changed))
+    if manifest:
+        with open(os.path.join(out_dir, "manifest.json"), "w") as f:
+            json.dump({"devices": manifest}, f, indent=1)
+
+    n = len(labels)
+    print(f"[layout] {n} labels in {elapsed:.2f} s "
+          f"({n / max(elapsed, 1e-9):.0f}/s): {len(changed)} written, "
+          f"{n - len(changed)} unchanged", file=sys.stderr)
+    if clipped:
+        print(f"[layout] text clipped: {', '.join(clipped)}", file=sys.stderr)
+
+
+def bench(templates, labels, count):
+    """Render labels round-robin count times; frames are not written."""
+    start = time.monotonic()
+    for i in range(count):
+        label = labels[i % len(labels)]
+        template_of(templates, label).frame(label)
+    elapsed = time.monotonic() - start
+    runs, codes = text_run.cache_info(), barcode.cache_info()
+    print(f"[bench] {count} labels in {elapsed:.3f} s: {count / elapsed:.0f}"
+          f"/s, {elapsed / count * 1e6:.0f} us each")
+    print(f"[bench] text runs {runs.hits} hits / {runs.misses} misses, "
+          f"barcodes {codes.hits} / {codes.misses}")
+
+
+def show(templates, labels, out_dir, lid):
+    """Render one label and update the tag, patching against the frame
+    last shown from out_dir (send.cmd_update)."""
+    import send
+    label = next((l for l in labels if str(l.get("id")) == lid), None)
+    if label is None:
+        raise ValueError(f"no label {lid!r}")
+    frame, _ = template_of(templates, label).frame(label)
+    path = os.path.join(out_dir, label_id(label) + ".bin")
+    previous = None
+    if os.path.exists(path):
+        with open(path, "rb") as f:
+            previous = f.read()
+
+    with send.open_serial(label.get("port", send.PORT)) as ser:
+        time.sleep(0.5)                 # let CDC enumerate
+        ser.reset_input_buffer()
+        send.cmd_update(ser, frame, previous)
+    with open(path, "wb") as f:
+        f.write(frame)
+
+
+# ── main ──────────────────────────────────────────────────────────────────────
+def main():
+    ap = argparse.ArgumentParser(
+        description="render JSON label templates into framebuffers")
+    ap.add_argument("labels", help="JSON with templates and labels")
+    ap.add_argument("-o", "--out", default=".", help="output directory")
+    ap.add_argument("--changed", action="store_true",
+                    help="skip labels whose frame matches hashes.json")
+    ap.add_argument("--preview", action="store_true",
+                    help="also write a PNG per label")
+    ap.add_argument("--show", metavar="ID",
+                    help="render one label and send it to its tag")
+    ap.add_argument("--bench", type=int, metavar="N",
+                    help="render N labels and report the rate")
+    args = ap.parse_args()
+
+    with open(args.labels) as f:
+        doc = json.load(f)
+    base_dir  = os.path.dirname(os.path.abspath(args.labels))
+    templates = load_templates(doc, base_dir)
+    labels    = doc.get("labels", [])
+    if not labels:
+        sys.exit("no labels")
+
+    if args.bench:
+        bench(templates, labels, args.bench)
+        return
+    os.makedirs(args.out, exist_ok=True)
+    if args.show:
+        show(templates, labels, args.out, args.show)
+    else:
+        render_all(templates, labels, args.out, args.changed, args.preview)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""
+matrix.py — build configuration matrix with size and cycle counts
+
+  make matrix                                   sizes only
+  make matrix MATRIX_ARGS="--port /dev/ttyACM1" sizes + cycles on target
+  python matrix.py --only large-speed-data --port /dev/ttyACM1 --json
+
+Builds every OPT (size, speed) x MEMMODEL (small, medium, large) x HOT
+(data, xdata) combination with BENCH=1 into out/matrix/<model>-<opt>-<hot>
+and reports flash, XRAM and free stack from the linker's .mem file. A
+configuration that does not fit (e.g. the small model's 128 bytes of
+directly addressed RAM) is reported as failed, not skipped.
+
+With --port, each one is linked for the serial bootloader (make app),
+flashed with flash.py and asked for CMD_BENCH: cycles per call of the
+hot functions, timed on the target by Timer 1 (see bench.h).
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import subprocess
+import sys
+import time
+
+from banks import load_ihx
+
+ROOT      = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+OPTS      = ("size", "speed")
+MODELS    = ("small", "medium", "large")
+HOTS      = ("data", "xdata")
+
+CMD_BENCH      = 0x6D
+BENCH_RX_BYTES = 16
+BENCH_NAMES    = ("spi_byte", "uart_getc", "uart_printf", "crc32_64",
+                  "asset_row", "text_row", "compose_row",
+                  "fill_c", "fill_cpu", "fill_dma", "copy_c", "copy_cpu",
+                  "copy_dma", "code_c", "code_dma", "invert_c", "invert_cpu",
+                  "xor_c", "xor_cpu", "row_c", "row_fb", "spi_row")
+ACK            = 0x06
+
+MEM_RE = {
+    "xram":  re.compile(r"EXTERNAL RAM\s+0x\w+\s+0x\w+\s+(\d+)"),
+    "pdata": re.compile(r"PAGED EXT\. RAM\s+(?:0x\w+\s+0x\w+\s+)?(\d+)"),
+    "flash": re.compile(r"ROM/EPROM/FLASH\s+0x\w+\s+0x\w+\s+(\d+)"),
+    "stack": re.compile(r"Stack starts at: 0x\w+ .*?with (\d+) bytes? available"),
+}
+
+
+def configs(only=None):
+    for model in MODELS:
+        for opt in OPTS:
+            for hot in HOTS:
+                name = f"{model}-{opt}-{hot}"
+                if not only or name in only:
+                    yield name, {"MEMMODEL": model, "OPT": opt, "HOT": hot}
+
+
+# ── build ─────────────────────────────────────────────────────────────────────
+def build(make, name, params, target):
+    outdir = os.path.join("out", "matrix", name)
+    cmd = [make, "-s", f"OUTDIR={outdir}", "BENCH=1", target] + \
+          [f"{k}={v}" for k, v in params.items()]
+    p = subprocess.run(cmd, cwd=ROOT, capture_output=True, text=True)
+    result = {"config": name, **params, "ok": p.returncode == 0}
+    if not result["ok"]:
+        lines = (p.stderr or p.stdout).strip().splitlines()
+        result["error"] = lines[-1] if lines else f"exit {p.returncode}"
+        return result, None
+
+    stem = "firmware-app" if target == "app" else "firmware"
+    ihx  = os.path.join(ROOT, outdir, stem + ".ihx")
+    result["code"] = len(load_ihx(ihx))
+    try:
+        with open(os.path.join(ROOT, outdir, stem + ".mem")) as f:
+            mem = f.read()
+        for key, rx in MEM_RE.items():
+            m = rx.search(mem)
+            result[key] = int(m.group(1)) if m else None
+    except OSError:
+        pass
+    return result, ihx
+
+
+# ── on target ─────────────────────────────────────────────────────────────────
+def bench(ser):
+    """Run CMD_BENCH → {name: cycles per call}."""
+    ser.reset_input_buffer()
+    ser.write(bytes([CMD_BENCH]))
+    if ser.read(1) != bytes([ACK]):
+        raise RuntimeError("no CMD_BENCH ACK — not a BENCH build?")
+    ser.write(bytes([0x55] * BENCH_RX_BYTES))
+    ser.flush()
+    while True:                               # skip the uart_printf line
+        b = ser.read(1)
+        if not b:
+            raise TimeoutError("no bench results")
+        if b[0] == ACK:
+            break
+    count = ser.read(1)[0]
+    cycles = {}
+    for _ in range(count):
+        rid, calls, total = struct.unpack("<BHI", ser.read(7))
+        name = BENCH_NAMES[rid] if rid < len(BENCH_NAMES) else f"bench{rid}"
+        cycles[name] = round(total / calls, 1) if calls else None
+    return cycles
+
+
+def flash_and_bench(ihx, port):
+    import flash
+    import send
+    send.VERBOSE = False
+    with send.open_serial(port) as ser:
+        ser.timeout = 2
+        time.sleep(0.5)
+        ser.reset_input_buffer()
+        info  = flash.enter_bootloader(ser)
+        image = flash.load_image(ihx, info["base"])
+        flash.flash(ser, image, info["base"], run=True)
+        time.sleep(1.0)                       # app boot banner
+        return bench(ser)
+
+
+# ── report ────────────────────────────────────────────────────────────────────
+def table(results, with_cycles):
+    cols = ["config", "code", "xram", "stack"]
+    if with_cycles:
+        cols += BENCH_NAMES
+    rows = []
+    for r in results:
+        if not r["ok"]:
+            rows.append([r["config"], "FAILED: " + r["error"]])
+            continue
+        row = [r["config"]] + [str(r.get(k, "")) if r.get(k) is not None
+                               else "-" for k in ("code", "xram", "stack")]
+        if with_cycles:
+            cyc = r.get("cycles") or {}
+            row += [str(cyc.get(n, "-")) for n in BENCH_NAMES]
+        rows.append(row)
+    widths = [max(len(c), *(len(r[i]) for r in rows if i < len(r) and
+                             not r[1].startswith("FAILED")))
+              for i, c in enumerate(cols)]
+    out = ["  ".join(c.rjust(w) if i else c.ljust(w)
+                     for i, (c, w) in enumerate(zip(cols, widths)))]
+    for r in rows:
+        if r[1].startswith("FAILED"):
+            out.append(f"{r[0].ljust(widths[0])}  {r[1]}")
+        else:
+            out.append("  ".join(c.rjust(w) if i else c.ljust(w)
+                                 for i, (c, w) in enumerate(zip(r, widths))))
+    return "\n".join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="SDCC configuration matrix")
+    ap.add_argument("--make", default="make")
+    ap.add_argument("--port", help="flash each build and run CMD_BENCH")
+    ap.add_argument("--only", nargs="+", metavar="CONFIG",
+                    help="e.g. large-speed-data")
+    ap.add_argument("--json", action="store_true")
+    args = ap.parse_args()
+
+    results = []
+    for name, params in configs(args.only):
+        print(f"[matrix] {name}", file=sys.stderr)
+        result, ihx = build(args.make, name, params,
+                            "app" if args.port else "all")
+        if ihx and args.port:
+            try:
+                result["cycles"] = flash_and_bench(ihx, args.port)
+            except Exception as e:            # noqa: BLE001 — keep going
+                result["bench_error"] = f"{type(e).__name__}: {e}"
+        results.append(result)
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+    else:
+        print(table(results, bool(args.port)))
+        for r in results:
+            if "bench_error" in r:
+                print(f"  {r['config']}: bench failed: {r['bench_error']}")
+    sys.exit(0 if any(r["ok"] for r in results) else 1)
+
+
+if __name__ == "__main__":
+    main()
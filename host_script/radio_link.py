@@ -0,0 +1,283 @@
+#!/usr/bin/env python3
+"""
+radio_link.py — host end of the tag's 802.15.4 link (link.h)
+
+Built with make LINK=radio the tag also takes commands as 802.15.4 data
+frames: the command stream is cut into fragments of up to 110 bytes,
+reassembled on the tag in order, acknowledged per frame and resent
+go-back-N. make LINK=loopback tunnels the same frames over the UART, so
+fragmentation, reassembly and windowing run without RF hardware:
+
+  python radio_link.py show image.bin         any send.py command
+  python radio_link.py --loss 0.2 show a.bin  drop 20% of the frames,
+                                              both ways, to exercise
+                                              the retransmissions
+  python radio_link.py --stats hash           frame counters at the end
+
+Link has the pyserial methods send.py uses (read, write, flush,
+reset_input_buffer, timeout), so its cmd_* functions run over it as is.
+The PHY is a class with send(mpdu) and recv(timeout); TunnelPhy is the
+UART tunnel, an 802.15.4 dongle would be another one.
+"""
+
+import argparse
+import random
+import struct
+import sys
+import time
+
+import serial
+
+import send
+
+# ── link.h ───────────────────────────────────────────────────────────────────
+LINK_PAN_ID    = 0xE1AB
+LINK_ADDR      = 0x0001     # the tag
+LINK_HOST_ADDR = 0x0000
+LINK_MPDU_MAX  = 127
+LINK_MHR_LEN   = 9
+LINK_HDR_LEN   = 6
+LINK_FCS_LEN   = 2
+LINK_DATA_MAX  = LINK_MPDU_MAX - LINK_MHR_LEN - LINK_HDR_LEN - LINK_FCS_LEN
+LINK_TUNNEL    = 0x4D
+LINK_SYN       = 0x01
+
+FCF            = b"\x41\x88"   # data frame, PAN ID compression, short addrs
+HOST_WIN       = 255           # we always have room
+RTO            = 0.1           # seconds, tag replies within a few ms
+SYN_TRIES      = 20
+
+HDR = struct.Struct("<2sBHHHBHHB")   # FCF, mac seq, PAN, dst, src,
+                                     # flags, seq16, ack16, win
+
+
+# ── PHY ──────────────────────────────────────────────────────────────────────
+class TunnelPhy:
+    """Frames over the UART of a LINK=loopback build: 0x4D, PHR, MPDU."""
+
+    def __init__(self, ser):
+        self.ser = ser
+        self.buf = bytearray()
+
+    def send(self, mpdu):
+        # FCS as the radio leaves it in the RX FIFO: RSSI, CRC OK
+        frame = mpdu + b"\x00\x80"
+        self.ser.write(bytes([LINK_TUNNEL, len(frame)]) + frame)
+        self.ser.flush()
+
+    def recv(self, timeout):
+        """One MPDU (FCS included), or None after timeout seconds."""
+        deadline = time.monotonic() + timeout
+        while True:
+            frame = self._parse()
+            if frame is not None:
+                return frame
+            left = deadline - time.monotonic()
+            if left <= 0:
+                return None
+            self.ser.timeout = min(left, 0.01)
+            self.buf += self.ser.read(max(1, self.ser.in_waiting))
+
+    def _parse(self):
+        # The UART also carries the boot messages, skip to a sane frame
+        while True:
+            start = self.buf.find(LINK_TUNNEL)
+            if start < 0:
+                self.buf.clear()
+                return None
+            del self.buf[:start]
+            if len(self.buf) < 2:
+                return None
+            n = self.buf[1]
+            if not HDR.size + LINK_FCS_LEN <= n <= LINK_MPDU_MAX:
+                del self.buf[0]
+                continue
+            if len(self.buf) < 2 + n:
+                return None
+            frame = bytes(self.buf[2:2 + n])
+            if frame[:2] != FCF:
+                del self.buf[0]
+                continue
+            del self.buf[:2 + n]
+            return frame
+
+    def close(self):
+        self.ser.close()
+
+
+# ── link ─────────────────────────────────────────────────────────────────────
+class Link:
+    """Byte stream to one tag, go-back-N like the tag's side in link.c."""
+
+    def __init__(self, phy, addr=LINK_ADDR, loss=0.0, timeout=send.ACK_TIMEOUT):
+        self.phy     = phy
+        self.addr    = addr
+        self.loss    = loss
+        self.timeout = timeout
+        self.mac_seq = 0
+        self.tx      = bytearray()   # from tx_base: in flight, then unsent
+        self.tx_base = 0
+        self.tx_sent = 0
+        self.rx      = bytearray()
+        self.rx_next = 0
+        self.peer_win = 0
+        self.deadline = None         # retransmit timer
+        self.stats = dict(frames_out=0, frames_in=0, lost_out=0, lost_in=0,
+                          resent=0, bytes_out=0, bytes_in=0)
+
+    # ── frames ──
+    def _frame(self, flags, seq, data=b""):
+        mpdu = HDR.pack(FCF, self.mac_seq, LINK_PAN_ID, self.addr,
+                        LINK_HOST_ADDR, flags, seq & 0xFFFF,
+                        self.rx_next & 0xFFFF, HOST_WIN) + data
+        self.mac_seq = (self.mac_seq + 1) & 0xFF
+        self.stats["frames_out"] += 1
+        if random.random() < self.loss:
+            self.stats["lost_out"] += 1
+            return
+        self.phy.send(mpdu)
+
+    def _output(self):
+        """Send what the tag has room for; start the timer."""
+        while True:
+            room = min(self.peer_win - self.tx_sent, LINK_DATA_MAX)
+            n = min(len(self.tx) - self.tx_sent, room)
+            if n <= 0:
+                return
+            data = bytes(self.tx[self.tx_sent:self.tx_sent + n])
+            self._frame(0, self.tx_base + self.tx_sent, data)
+            self.tx_sent += n
+            if self.deadline is None:
+                self.deadline = time.monotonic() + RTO
+
+    def _input(self, mpdu):
+        if random.random() < self.loss:
+            self.stats["lost_in"] += 1
+            return None
+        (_, _, pan, dst, src, flags, seq, ack,
+         win) = HDR.unpack_from(mpdu)
+        if pan != LINK_PAN_ID or dst != LINK_HOST_ADDR or src != self.addr:
+            return None
+        self.stats["frames_in"] += 1
+        if flags & LINK_SYN:
+            self.rx_next = seq
+
+        acked = (ack - self.tx_base) & 0xFFFF
+        if 0 < acked <= self.tx_sent:
+            del self.tx[:acked]
+            self.tx_base = (self.tx_base + acked) & 0xFFFF
+            self.tx_sent -= acked
+            self.deadline = time.monotonic() + RTO if self.tx_sent else None
+        self.peer_win = win
+
+        data = mpdu[HDR.size:-LINK_FCS_LEN]
+        if data:
+            if seq == self.rx_next:
+                self.rx += data
+                self.rx_next = (self.rx_next + len(data)) & 0xFFFF
+                self.stats["bytes_in"] += len(data)
+            self._frame(0, self.tx_base + self.tx_sent)     # ack
+        return flags
+
+    def _pump(self, until):
+        """Run the link until until() or the timeout; False on timeout."""
+        end = time.monotonic() + self.timeout
+        while not until():
+            now = time.monotonic()
+            if now >= end:
+                return False
+            if self.deadline is not None and now >= self.deadline:
+                self.stats["resent"] += 1      # go back to the oldest unacked
+                self.tx_sent = 0
+                self.deadline = None
+            self._output()
+            wait = end - now
+            if self.deadline is not None:
+                wait = min(wait, max(0.0, self.deadline - now))
+            mpdu = self.phy.recv(min(wait, 0.05))
+            if mpdu is not None:
+                self._input(mpdu)
+        return True
+
+    def connect(self):
+        """SYN until the tag answers: both streams start over."""
+        for _ in range(SYN_TRIES):
+            self.tx_base, self.tx_sent, self.rx_next = 0, 0, 0
+            self._frame(LINK_SYN, 0)
+            end = time.monotonic() + RTO
+            while time.monotonic() < end:
+                mpdu = self.phy.recv(end - time.monotonic())
+                if mpdu is not None and (self._input(mpdu) or 0) & LINK_SYN:
+                    return self
+        raise TimeoutError("Tag did not answer the link SYN")
+
+    # ── pyserial subset for send.py ──
+    def write(self, data):
+        self.tx += data
+        self.stats["bytes_out"] += len(data)
+        self._output()
+        return len(data)
+
+    def flush(self):
+        """Wait until everything written has been sent once."""
+        if not self._pump(lambda: self.tx_sent >= len(self.tx)):
+            raise TimeoutError("Link stalled, tag not acknowledging")
+
+    def read(self, n=1):
+        self._pump(lambda: len(self.rx) >= n)
+        data = bytes(self.rx[:n])
+        del self.rx[:n]
+        return data
+
+    def reset_input_buffer(self):
+        self.rx.clear()
+
+    def close(self):
+        self.phy.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+def open_link(port=send.PORT, loss=0.0):
+    """Link to a LINK=loopback tag on a serial port."""
+    ser = serial.Serial(port, send.BAUD, timeout=0.01)
+    time.sleep(0.5)                 # let CDC enumerate
+    ser.reset_input_buffer()
+    return Link(TunnelPhy(ser), loss=loss).connect()
+
+
+# ── main ─────────────────────────────────────────────────────────────────────
+def main():
+    ap = argparse.ArgumentParser(
+        description="send.py commands over the 802.15.4 link (UART tunnel)")
+    ap.add_argument("--port", default=send.PORT)
+    ap.add_argument("--loss", type=float, default=0.0,
+                    help="fraction of frames to drop each way")
+    ap.add_argument("--seed", type=int, help="random seed for --loss")
+    ap.add_argument("--stats", action="store_true", help="print frame counters")
+    ap.add_argument("command", nargs=argparse.REMAINDER,
+                    help="send.py command and arguments")
+    args = ap.parse_args()
+    if not args.command:
+        ap.error("missing send.py command")
+    if args.seed is not None:
+        random.seed(args.seed)
+
+    link = open_link(args.port, args.loss)
+    # send.main() opens its port itself
+    send.open_serial = lambda port=None: link
+    send.CHUNK_DELAY = 0            # the link's window paces the upload
+    sys.argv = ["send.py"] + args.command
+    try:
+        send.main()
+    finally:
+        if args.stats:
+            print(" ".join(f"{k}={v}" for k, v in link.stats.items()))
+
+
+if __name__ == "__main__":
+    main()
@@ -7,36 +7,135 @@ Commands:
   python eink.py send <file.bin>    — upload framebuffer to MCU RAM
   python eink.py write              — display the buffer currently in MCU RAM
   python eink.py show  <file.bin>   — send + write in one step
+  (send/show also take any image, converted by convert.py)
+  python eink.py hash  [file.bin]   — print frame hashes on the MCU
+  python eink.py text  <line>...    — draw text lines without a framebuffer
+  python eink.py compose <bg> <file.bin> <col> <y> <w> <h>
+                                    — flash background + one rect of a frame
+  python eink.py update <file.bin> [previous.bin]
+                                    — upload (or patch against previous),
+                                      check and write in one round trip
+  python eink.py spi [cal]          — SPI clock in use (cal: recalibrate)
+  python eink.py seq <file>|default — replace the panel's command sequences
 
 Protocol:
   CMD_SEND  (0x69) + 2756 bytes  → MCU stores in __xdata framebuffer, ACKs
   CMD_WRITE (0x57)               → MCU sends framebuffer to EPD, ACKs when done
+  CMD_WRITE_CHANGED (0x77)       → as CMD_WRITE, but no refresh if the
+                                   buffer hash equals the shown hash
   CMD_CLEAR (0x43)               → MCU clears EPD, ACKs when done
-  ACK = 0x06
+  CMD_HASH  (0x48)               → ACK, flags, shown CRC32, buffer CRC32
+                                   (little endian, zlib.crc32 compatible)
+  CMD_TEXT_MAP   (0x54) + 13 row attrs + 13×35 cells → ACK, stored, ACK
+  CMD_TEXT_PUT   (0x74) + row, col, attr, len, chars → ACK, stored, ACK
+  CMD_TEXT_WRITE (0x44)          → MCU renders the tile map while sending
+                                   it to the EPD, ACKs when done
+  CMD_BACKGROUND (0x62) + index  → ACK | NAK (0 white, n: frame asset n-1)
+  CMD_OVERLAYS   (0x4F) + count, count × (op, col, w, y, h, w×h bytes)
+                                 → ACK, ACK | NAK if one didn't fit
+  CMD_COMPOSE    (0x63)          → MCU draws background + overlays, ACKs
+  CMD_BATCH      (0x5A) + count, len u16, count × (opcode, args, data)
+                                 → ACK, count, results, flags, shown CRC32,
+                                   buffer CRC32 once all are done (Batch)
+  CMD_SPI        (0x53) + 0 | 1 (recalibrate)
+                                 → ACK, state, rate, kHz u16, passed mask,
+                                   0x70 revision (4), 0x71 status
+  CMD_EPD_SEQ    (0x45) + len u16 → ACK | NAK (a sequence is running, retry)
+                 + len bytes      → ACK | NAK (invalid, built-ins kept)
+  any other byte                 → NAK
+  ACK = 0x06, NAK = 0x15
+
+The drawing commands (WRITE, CLEAR, TEXT_WRITE, COMPOSE) send their
+second ACK when the refresh is done, but the MCU keeps serving uploads
+meanwhile: CMD_SEND, CMD_TEXT_MAP and CMD_TEXT_PUT may follow the first
+ACK (cmd_write(wait=False)). Their ACKs and the refresh's are all 0x06,
+so count them; any other command is held until the refresh is done.
 """
 
+import os
+import re
 import serial
+import struct
 import sys
 import time
+import zlib
 
 # ── config ────────────────────────────────────────────────────────────────────
-PORT            = "/dev/ttyACM1"
+PORT            = os.environ.get("EINK_PORT", "/dev/ttyACM1")
 BAUD            = 921600
 FRAMEBUFFER_SIZE = 2756
 
 CMD_SEND  = 0x69   # upload buffer to MCU RAM only
 CMD_WRITE = 0x57   # send MCU RAM buffer to EPD
 CMD_CLEAR = 0x43   # clear EPD
+CMD_WRITE_CHANGED = 0x77   # CMD_WRITE unless the frame is already shown
+CMD_HASH  = 0x48   # query shown/buffer frame hashes
+
+HASH_SHOWN_VALID  = 0x01
+HASH_BUFFER_VALID = 0x02
+
+CMD_TEXT_MAP   = 0x54  # row attributes + whole tile map
+CMD_TEXT_PUT   = 0x74  # characters at row/col
+CMD_TEXT_WRITE = 0x44  # draw the tile map
+
+# text mode, see text.h: 35×13 cells of 6×8 px on the panel in landscape
+TEXT_COLS, TEXT_ROWS = 35, 13
+TEXT_TALL     = 0x01   # row attr: double height, covers the next row
+TEXT_WIDE     = 0x02   # row attr: double width
+TEXT_INVERSE  = 0x80   # cell bit: inverse video
+TEXT_CHARMAP  = {"€": 0x7F}
+
+CMD_BACKGROUND = 0x62  # select the flash background
+CMD_OVERLAYS   = 0x4F  # replace the RAM overlay rectangles
+CMD_COMPOSE    = 0x63  # draw background + overlays
+
+# composition, see compose.h; overlays are in framebuffer coordinates:
+# byte column 0-12, panel row 0-211
+COMPOSE_BG_WHITE = 0   # else asset id + 1, see assets/assets.list
+COMPOSE_REPLACE, COMPOSE_OR, COMPOSE_AND, COMPOSE_XOR = 0, 1, 2, 3
+COMPOSE_MAX_OVERLAYS = 4
+COMPOSE_POOL_SIZE    = 1024
+ROW_BYTES            = 13
+NAK                  = 0x15
+
+CMD_BATCH = 0x5A   # several operations, one status record
+
+# batch operations and results, see uart_rx.h
+BATCH_MAX = 32
+BATCH_UPLOAD, BATCH_PATCH, BATCH_CHECK = 0x01, 0x02, 0x03
+BATCH_WRITE, BATCH_WRITE_CHANGED, BATCH_CLEAR = 0x04, 0x05, 0x06
+BATCH_TEXT, BATCH_COMPOSE, BATCH_SLEEP = 0x07, 0x08, 0x09
+BATCH_DRAWS = {BATCH_WRITE, BATCH_WRITE_CHANGED, BATCH_CLEAR, BATCH_TEXT,
+               BATCH_COMPOSE}
+BATCH_OK, BATCH_UNCHANGED, BATCH_BAD, BATCH_MISMATCH, BATCH_NOT_RUN = range(5)
+BATCH_RESULTS = ["ok", "unchanged", "bad", "mismatch", "not run"]
+PATCH_OVERHEAD = 5     # opcode, offset, length
+
+CMD_SPI = 0x53     # SPI clock calibration, see GxGDEW0213Z16.h
+SPI_CAL_STATES = ["pending", "done", "no reply"]
+EPD_REV_LEN    = 4
+
+CMD_EPD_SEQ = 0x45 # panel command sequences, see GxGDEW0213Z16.h
+SEQ_NAMES   = ("init", "frame", "refresh", "sleep")
+SEQ_CMD, SEQ_DATA, SEQ_DELAY, SEQ_GAP = 0x00, 0x10, 0x20, 0x21
+SEQ_WAIT_BUSY, SEQ_RESET, SEQ_TEMP, SEQ_END = 0x22, 0x23, 0x24, 0xFF
+SEQ_MAX_DATA = 15      # per CMD/DATA op
+EPD_SEQ_RAM  = 256
 
 ACK           = 0x06
 ACK_TIMEOUT   = 30     # seconds — EPD refresh takes ~3s
 CHUNK_SIZE    = 64     # bytes per chunk during framebuffer upload
-CHUNK_DELAY   = 0.002  # 2ms between chunks — gives CC2530 time to read each
+CHUNK_DELAY   = 0.002  # 2ms between chunks — the MCU's RX ring is 256 bytes
+VERBOSE       = True   # progress output; tools importing this module may mute it
 
 # ── serial helpers ────────────────────────────────────────────────────────────
-def open_serial():
+def log(*args, **kwargs):
+    if VERBOSE:
+        print(*args, **kwargs)
+
+def open_serial(port=PORT):
     return serial.Serial(
-        port=PORT,
+        port=port,
         baudrate=BAUD,
         bytesize=serial.EIGHTBITS,
         parity=serial.PARITY_NONE,
@@ -50,7 +149,7 @@ def wait_ack(ser, label=""):
         raise TimeoutError(f"No ACK received{' for ' + label if label else ''}")
     if b[0] != ACK:
         raise RuntimeError(f"Expected ACK 0x06, got 0x{b[0]:02x}{' (' + label + ')' if label else ''}")
-    print(f"  ✓ ACK{' [' + label + ']' if label else ''}")
+    log(f"  ✓ ACK{' [' + label + ']' if label else ''}")
 
 # ── commands ──────────────────────────────────────────────────────────────────
 def cmd_send(ser, framebuffer):
@@ -58,7 +157,7 @@ def cmd_send(ser, framebuffer):
     if len(framebuffer) != FRAMEBUFFER_SIZE:
         raise ValueError(f"Expected {FRAMEBUFFER_SIZE} bytes, got {len(framebuffer)}")
 
-    print(f"[send] uploading {FRAMEBUFFER_SIZE} bytes to MCU RAM...")
+    log(f"[send] uploading {FRAMEBUFFER_SIZE} bytes to MCU RAM...")
     ser.write(bytes([CMD_SEND]))
     ser.flush()
 
@@ -72,29 +171,467 @@ def cmd_send(ser, framebuffer):
         sent += len(chunk)
         time.sleep(CHUNK_DELAY)
         if sent % 512 == 0 or sent >= FRAMEBUFFER_SIZE:
-            print(f"  {sent}/{FRAMEBUFFER_SIZE} bytes", end="\r")
+            log(f"  {sent}/{FRAMEBUFFER_SIZE} bytes", end="\r")
 
-    print()
+    log()
     wait_ack(ser, "buffer stored")    # MCU ACK 2: all bytes received
-    print("[send] done")
+    log("[send] done")
 
-def cmd_write(ser):
-    """Tell MCU to push its RAM buffer to the EPD."""
-    print("[write] sending buffer to display...")
-    ser.write(bytes([CMD_WRITE]))
+def cmd_write(ser, if_changed=False, wait=True):
+    """Tell MCU to push its RAM buffer to the EPD.
+
+    With wait=False, return once the frame is accepted; the caller may
+    upload the next frame during the refresh and must then read one more
+    ACK (wait_ack) before any command other than an upload."""
+    log("[write] sending buffer to display...")
+    ser.write(bytes([CMD_WRITE_CHANGED if if_changed else CMD_WRITE]))
     ser.flush()
     wait_ack(ser, "EPD starting")     # MCU ACK 1: command received
+    if not wait:
+        return
     wait_ack(ser, "EPD done")         # MCU ACK 2: refresh complete
-    print("[write] display updated")
+    log("[write] display updated")
 
 def cmd_clear(ser):
     """Clear the display."""
-    print("[clear] clearing display...")
+    log("[clear] clearing display...")
     ser.write(bytes([CMD_CLEAR]))
     ser.flush()
     wait_ack(ser, "clear starting")   # MCU ACK 1: command received
     wait_ack(ser, "clear done")       # MCU ACK 2: refresh complete
-    print("[clear] done")
+    log("[clear] done")
+
+def cmd_hash(ser):
+    """Return (shown, buffer) CRC32s on the MCU, None where unknown."""
+    ser.write(bytes([CMD_HASH]))
+    ser.flush()
+    wait_ack(ser, "hash")
+    reply = ser.read(9)
+    if len(reply) != 9:
+        raise TimeoutError("Short hash reply")
+    flags, shown, buffer = struct.unpack("<BII", reply)
+    return (shown if flags & HASH_SHOWN_VALID else None,
+            buffer if flags & HASH_BUFFER_VALID else None)
+
+def load_frame(path):
+    """Framebuffer from a .bin file, or any image through convert.py."""
+    if path.endswith(".bin"):
+        with open(path, "rb") as f:
+            return f.read()
+    from convert import load_frame as convert_frame   # numpy + Pillow
+    return convert_frame(path)
+
+def frame_hash(framebuffer):
+    return zlib.crc32(framebuffer) & 0xFFFFFFFF
+
+def cmd_show(ser, framebuffer):
+    """send + write, skipping whatever the MCU already has.
+
+    Returns (refreshed, uploaded): refreshed is False if the frame was
+    already displayed, uploaded whether the frame was sent."""
+    local = frame_hash(framebuffer)
+    shown, buffer = cmd_hash(ser)
+    if shown == local:
+        log(f"[show] frame {local:08x} already displayed, nothing to do")
+        return False, False
+
+    uploaded = buffer != local
+    if uploaded:
+        cmd_send(ser, framebuffer)
+        _, buffer = cmd_hash(ser)
+        if buffer != local:
+            raise RuntimeError(f"Upload corrupted: MCU has {buffer:08x}, "
+                               f"expected {local:08x}")
+    else:
+        log(f"[show] frame {local:08x} already in MCU RAM, skipping upload")
+
+    cmd_write(ser, if_changed=True)
+    return True, uploaded
+
+# ── text mode ─────────────────────────────────────────────────────────────────
+def text_encode(line):
+    """str → cell bytes; characters outside the font become '?'."""
+    out = bytearray()
+    for ch in line:
+        code = TEXT_CHARMAP.get(ch, ord(ch))
+        out.append(code if 0x20 <= code <= 0x7F else ord("?"))
+    return bytes(out)
+
+def text_layout(lines):
+    """Lines → (attrs, cells) for CMD_TEXT_MAP.
+
+    A leading '!' makes a line tall (two rows), '!!' tall and wide;
+    text between '*' is drawn inverted."""
+    attrs = bytearray(TEXT_ROWS)
+    cells = bytearray(b" " * (TEXT_ROWS * TEXT_COLS))
+    row = 0
+    for line in lines:
+        attr = 0
+        if line.startswith("!!"):
+            attr, line = TEXT_TALL | TEXT_WIDE, line[2:]
+        elif line.startswith("!"):
+            attr, line = TEXT_TALL, line[1:]
+        if row >= TEXT_ROWS:
+            raise ValueError("too many lines for the display")
+        attrs[row] = attr
+        inverse, col = False, 0
+        for part in re.split(r"(\*)", line):
+            if part == "*":
+                inverse = not inverse
+                continue
+            for b in text_encode(part):
+                if col < TEXT_COLS:
+                    cells[row * TEXT_COLS + col] = b | (TEXT_INVERSE if inverse else 0)
+                col += 1
+        row += 2 if attr & TEXT_TALL else 1
+    return bytes(attrs), bytes(cells)
+
+def cmd_text_map(ser, attrs, cells):
+    """Upload row attributes and the whole tile map."""
+    if len(attrs) != TEXT_ROWS or len(cells) != TEXT_ROWS * TEXT_COLS:
+        raise ValueError("tile map must be 13 attrs + 13×35 cells")
+    ser.write(bytes([CMD_TEXT_MAP]))
+    ser.flush()
+    wait_ack(ser, "ready for map")
+    ser.write(attrs + cells)
+    ser.flush()
+    wait_ack(ser, "map stored")
+
+def cmd_text_put(ser, row, col, text, attr=0):
+    """Overwrite part of one row, e.g. just a price."""
+    data = text_encode(text) if isinstance(text, str) else bytes(text)
+    ser.write(bytes([CMD_TEXT_PUT]))
+    ser.flush()
+    wait_ack(ser, "ready for text")
+    ser.write(bytes([row, col, attr, len(data)]) + data)
+    ser.flush()
+    wait_ack(ser, "text stored")
+
+def cmd_text_write(ser):
+    """Draw the tile map."""
+    log("[text] drawing tile map...")
+    ser.write(bytes([CMD_TEXT_WRITE]))
+    ser.flush()
+    wait_ack(ser, "EPD starting")
+    wait_ack(ser, "EPD done")
+    log("[text] display updated")
+
+# ── composition ───────────────────────────────────────────────────────────────
+def overlay_from_frame(framebuffer, col, y, w, h, op=COMPOSE_REPLACE):
+    """Cut an overlay rectangle out of a full framebuffer."""
+    data = b"".join(framebuffer[(y + r) * ROW_BYTES + col:
+                                (y + r) * ROW_BYTES + col + w]
+                    for r in range(h))
+    return (op, col, w, y, h, data)
+
+def cmd_background(ser, index):
+    ser.write(bytes([CMD_BACKGROUND, index]))
+    ser.flush()
+    wait_ack(ser, f"background {index}")
+
+def cmd_overlays(ser, overlays):
+    """Replace all overlays; each is (op, col, w, y, h, data)."""
+    if len(overlays) > COMPOSE_MAX_OVERLAYS:
+        raise ValueError(f"at most {COMPOSE_MAX_OVERLAYS} overlays")
+    payload = bytearray([len(overlays)])
+    used = 0
+    for op, col, w, y, h, data in overlays:
+        if len(data) != w * h:
+            raise ValueError(f"overlay {w}×{h} needs {w * h} bytes")
+        used += len(data)
+        payload += bytes([op, col, w, y, h]) + data
+    if used > COMPOSE_POOL_SIZE:
+        raise ValueError(f"overlays need {used} bytes, pool is "
+                         f"{COMPOSE_POOL_SIZE}")
+    ser.write(bytes([CMD_OVERLAYS]))
+    ser.flush()
+    wait_ack(ser, "ready for overlays")
+    ser.write(payload)
+    ser.flush()
+    wait_ack(ser, "overlays stored")
+
+def cmd_compose(ser):
+    log("[compose] drawing background + overlays...")
+    ser.write(bytes([CMD_COMPOSE]))
+    ser.flush()
+    wait_ack(ser, "EPD starting")
+    wait_ack(ser, "EPD done")
+    log("[compose] display updated")
+
+# ── batches ───────────────────────────────────────────────────────────────────
+class Batch:
+    """Operations for one CMD_BATCH, built up with the methods below.
+
+    The tag holds the batch while a drawing operation refreshes, with
+    the rest of it waiting in its 256-byte RX ring, so after a draw only
+    check and sleep may follow. A check hashes the buffer for ~30 ms,
+    longer than the ring lasts, so no upload or patch may follow it."""
+
+    def __init__(self):
+        self.ops = []          # (opcode, args + data)
+        self.drawn = False
+        self.checked = False
+
+    def _add(self, op, payload=b""):
+        if len(self.ops) >= BATCH_MAX:
+            raise ValueError(f"at most {BATCH_MAX} operations per batch")
+        if self.drawn and (payload and op != BATCH_CHECK or op in BATCH_DRAWS):
+            raise ValueError("only check and sleep may follow a draw")
+        if self.checked and op in (BATCH_UPLOAD, BATCH_PATCH):
+            raise ValueError("upload and patch may not follow a check")
+        self.drawn |= op in BATCH_DRAWS
+        self.checked |= op == BATCH_CHECK
+        self.ops.append((op, bytes(payload)))
+        return self
+
+    def upload(self, framebuffer):
+        if len(framebuffer) != FRAMEBUFFER_SIZE:
+            raise ValueError(f"Expected {FRAMEBUFFER_SIZE} bytes, got {len(framebuffer)}")
+        return self._add(BATCH_UPLOAD, framebuffer)
+
+    def patch(self, offset, data):
+        if offset + len(data) > FRAMEBUFFER_SIZE:
+            raise ValueError(f"patch {offset}+{len(data)} outside the framebuffer")
+        return self._add(BATCH_PATCH,
+                         struct.pack("<HH", offset, len(data)) + data)
+
+    def check(self, crc):
+        """Stop the batch unless the MCU buffer has this CRC32."""
+        return self._add(BATCH_CHECK, struct.pack("<I", crc))
+
+    def write(self, if_changed=False):
+        return self._add(BATCH_WRITE_CHANGED if if_changed else BATCH_WRITE)
+
+    def clear(self):
+        return self._add(BATCH_CLEAR)
+
+    def text(self):
+        return self._add(BATCH_TEXT)
+
+    def compose(self):
+        return self._add(BATCH_COMPOSE)
+
+    def sleep(self):
+        return self._add(BATCH_SLEEP)
+
+    def encode(self):
+        body = b"".join(bytes([op]) + payload for op, payload in self.ops)
+        if len(body) > 0xFFFF:
+            raise ValueError(f"batch of {len(body)} bytes, at most 65535")
+        return bytes([CMD_BATCH, len(self.ops)]) + \
+            struct.pack("<H", len(body)) + body
+
+def frame_patches(previous, framebuffer):
+    """Changed byte runs as (offset, data); runs closer than a patch
+    header are merged."""
+    runs = []
+    i = 0
+    while i < FRAMEBUFFER_SIZE:
+        if previous[i] == framebuffer[i]:
+            i += 1
+            continue
+        start = end = i
+        while i < FRAMEBUFFER_SIZE and i - end <= PATCH_OVERHEAD:
+            if previous[i] != framebuffer[i]:
+                end = i
+            i += 1
+        runs.append((start, framebuffer[start:end + 1]))
+        i = end + 1
+    return runs
+
+def cmd_batch(ser, batch):
+    """Run a Batch; returns (results, shown, buffer), hashes None where
+    unknown. Uploads are paced like cmd_send."""
+    data = batch.encode()
+    log(f"[batch] {len(batch.ops)} operations, {len(data)} bytes...")
+    for sent in range(0, len(data), CHUNK_SIZE):
+        ser.write(data[sent:sent + CHUNK_SIZE])
+        ser.flush()
+        time.sleep(CHUNK_DELAY)
+
+    b = ser.read(1)
+    if not b:
+        raise TimeoutError("No batch status received")
+    if b[0] != ACK:
+        raise RuntimeError(f"Batch refused: 0x{b[0]:02x}")
+    n = ser.read(1)
+    reply = ser.read(n[0] + 9) if n else b""
+    if not n or len(reply) != n[0] + 9:
+        raise TimeoutError("Short batch status")
+    results = list(reply[:n[0]])
+    flags, shown, buffer = struct.unpack("<BII", reply[n[0]:])
+    log("[batch] " + ", ".join(BATCH_RESULTS[r] if r < len(BATCH_RESULTS)
+                               else f"0x{r:02x}" for r in results))
+    return (results,
+            shown if flags & HASH_SHOWN_VALID else None,
+            buffer if flags & HASH_BUFFER_VALID else None)
+
+def cmd_update(ser, framebuffer, previous=None):
+    """Show a frame in one round trip: the changes against previous (the
+    frame the MCU is believed to hold) or the whole frame, a CRC check
+    and a write unless already shown.
+
+    Falls back to a full upload if previous was not what the MCU had.
+    Returns False if the frame was already displayed, True otherwise."""
+    local = frame_hash(framebuffer)
+    batch = Batch()
+    patches = frame_patches(previous, framebuffer) if previous else None
+    if patches is not None and len(patches) < BATCH_MAX - 2 and \
+       sum(len(d) + PATCH_OVERHEAD for _, d in patches) < FRAMEBUFFER_SIZE:
+        for offset, data in patches:
+            batch.patch(offset, data)
+    else:
+        batch.upload(framebuffer)
+    batch.check(local).write(if_changed=True)
+
+    results, _, buffer = cmd_batch(ser, batch)
+    if results[-2] == BATCH_MISMATCH and batch.ops[0][0] == BATCH_PATCH:
+        log(f"[update] MCU had {buffer:08x}, not the previous frame")
+        return cmd_update(ser, framebuffer)
+    if results[-2] != BATCH_OK:
+        raise RuntimeError(f"Upload corrupted: MCU has {buffer:08x}, "
+                           f"expected {local:08x}")
+    return results[-1] == BATCH_OK
+
+# ── SPI clock ─────────────────────────────────────────────────────────────────
+def cmd_spi(ser, calibrate=False):
+    """SPI clock the MCU drives the panel with, as a dict.
+
+    calibrate=True reruns the calibration: now if the panel is powered,
+    else at its next power-up (state "pending")."""
+    ser.write(bytes([CMD_SPI, 1 if calibrate else 0]))
+    ser.flush()
+    wait_ack(ser, "spi")
+    reply = ser.read(5 + EPD_REV_LEN + 1)
+    if len(reply) != 5 + EPD_REV_LEN + 1:
+        raise TimeoutError("Short SPI reply")
+    state, rate, khz, passed = struct.unpack_from("<BBHB", reply)
+    return dict(state=SPI_CAL_STATES[state] if state < len(SPI_CAL_STATES)
+                else state,
+                rate=rate, khz=khz, passed=passed,
+                revision=reply[5:5 + EPD_REV_LEN].hex(), status=reply[-1])
+
+# ── panel sequences ───────────────────────────────────────────────────────────
+def seq_assemble(text):
+    """Sequence source → the set CMD_EPD_SEQ takes.
+
+    Sections [init], [frame], [refresh], [sleep], one op per line, bytes
+    in hex, '#' comments:
+        CMD 61 68 00 d4     command and data, split into DATA ops past 15
+        DATA 00 ...         more data for the last command
+        DELAY 10            ms, decimal
+        GAP                 pad of the temperature band
+        WAIT_BUSY           0x71, BUSY, settle time of the band
+        RESET 0|1           RST pin
+        TEMP                sensor → band, 0xE0/0xE5
+    END is implied. Sections left out keep the firmware's built-in."""
+    code, name = {}, None
+    for n, line in enumerate(text.splitlines(), 1):
+        words = line.split("#")[0].split()
+        if not words:
+            continue
+        m = re.fullmatch(r"\[(\w+)\]", words[0])
+        if m:
+            name = m.group(1).lower()
+            if name not in SEQ_NAMES:
+                raise ValueError(f"line {n}: no sequence [{name}]")
+            code[name] = bytearray()
+            continue
+        if name is None:
+            raise ValueError(f"line {n}: op outside a [sequence]")
+        op, args = words[0].upper(), words[1:]
+        out = code[name]
+        try:
+            if op in ("CMD", "DATA"):
+                data = bytes(int(a, 16) for a in args)
+                if op == "CMD":
+                    if not data:
+                        raise ValueError("CMD needs the command byte")
+                    chunk = data[1:1 + SEQ_MAX_DATA]
+                    out += bytes([SEQ_CMD + len(chunk), data[0]]) + chunk
+                    data = data[1 + SEQ_MAX_DATA:]
+                for i in range(0, len(data), SEQ_MAX_DATA):
+                    chunk = data[i:i + SEQ_MAX_DATA]
+                    out += bytes([SEQ_DATA + len(chunk)]) + chunk
+            elif op == "DELAY":
+                ms = int(args[0])
+                while ms > 0:
+                    out += bytes([SEQ_DELAY, min(ms, 255)])
+                    ms -= 255
+            elif op == "RESET":
+                out += bytes([SEQ_RESET, int(args[0]) & 1])
+            elif op in ("GAP", "WAIT_BUSY", "TEMP"):
+                out.append({"GAP": SEQ_GAP, "WAIT_BUSY": SEQ_WAIT_BUSY,
+                            "TEMP": SEQ_TEMP}[op])
+            else:
+                raise ValueError(f"unknown op {op}")
+        except (ValueError, IndexError) as e:
+            raise ValueError(f"line {n}: {line.strip()}: {e}") from None
+
+    # all sequences up to the last one given, END alone keeps a built-in
+    last = max((SEQ_NAMES.index(k) for k in code), default=-1)
+    data = b"".join(bytes(code.get(SEQ_NAMES[i], b"")) + bytes([SEQ_END])
+                    for i in range(last + 1))
+    if len(data) > EPD_SEQ_RAM:
+        raise ValueError(f"sequences take {len(data)} bytes, the tag has "
+                         f"{EPD_SEQ_RAM}")
+    return data
+
+def seq_split(data):
+    """A CMD_EPD_SEQ set → {name: ops without END} for the sequences it
+    replaces; ValueError where the firmware would NAK (EPD_SeqLoad)."""
+    seqs, i = {}, 0
+    for name in SEQ_NAMES:
+        if i >= len(data):
+            break
+        start = i
+        while True:
+            if i >= len(data):
+                raise ValueError(f"[{name}] has no END")
+            op = data[i]
+            i += 1
+            if op < SEQ_DATA:
+                i += (op & 0x0F) + 1
+            elif op < SEQ_DELAY:
+                i += op & 0x0F
+            elif op in (SEQ_DELAY, SEQ_RESET):
+                i += 1
+            elif op == SEQ_END:
+                break
+            elif op > SEQ_TEMP:
+                raise ValueError(f"[{name}] unknown op 0x{op:02x}")
+        if i - start > 1:
+            seqs[name] = data[start:i - 1]
+    if i != len(data):
+        raise ValueError(f"{len(data) - i} bytes after the last sequence")
+    return seqs
+
+def cmd_epd_seq(ser, data, retries=20):
+    """Replace the panel sequences with a set from seq_assemble() until
+    the tag resets; b"" goes back to the built-in ones. The tag refuses
+    while a sequence runs (power-up or the idle power-off), so that is
+    retried."""
+    header = bytes([CMD_EPD_SEQ]) + struct.pack("<H", len(data))
+    for _ in range(retries):
+        ser.write(header)
+        ser.flush()
+        b = ser.read(1)
+        if not b:
+            raise TimeoutError("No reply to CMD_EPD_SEQ")
+        if b[0] == ACK:
+            break
+        if b[0] != NAK:
+            raise RuntimeError(f"Expected ACK 0x06, got 0x{b[0]:02x} (seq)")
+        time.sleep(0.1)
+    else:
+        raise RuntimeError("Tag kept refusing the sequences (busy?)")
+    ser.write(data)
+    ser.flush()
+    b = ser.read(1)
+    if not b or b[0] != ACK:
+        raise RuntimeError("Tag rejected the sequences, built-ins kept")
+    log(f"[seq] {len(data)} bytes loaded" if data else
+        "[seq] built-in sequences restored")
 
 # ── main ──────────────────────────────────────────────────────────────────────
 USAGE = """
@@ -103,6 +640,21 @@ Usage:
   python eink.py send  <file.bin>   upload image to MCU RAM
   python eink.py write              push MCU RAM to display
   python eink.py show  <file.bin>   send + write (upload and display)
+  python eink.py hash  [file.bin]   print MCU frame hashes (and the file's)
+  python eink.py text  <line>...    draw text lines (landscape, 35×13 cells)
+                                    "!Big" tall, "!!Big" tall+wide, "*inv*"
+  python eink.py compose <bg> <file.bin> <col> <y> <w> <h>
+                                    draw flash background <bg> with the
+                                    rect (byte col, row, bytes, rows) of
+                                    file.bin on top; only the rect is sent
+  python eink.py update <file.bin> [previous.bin]
+                                    upload or patch, check and write in
+                                    one batch (CMD_BATCH)
+  python eink.py spi [cal]          show the SPI clock and calibration,
+                                    cal: measure it again
+  python eink.py seq <file>         load panel command sequences into the
+                                    tag's RAM (format: seq_assemble)
+  python eink.py seq default        back to the built-in sequences
 """
 
 def main():
@@ -123,9 +675,7 @@ def main():
             if len(sys.argv) < 3:
                 print("Error: send requires a binary file argument")
                 sys.exit(1)
-            with open(sys.argv[2], "rb") as f:
-                fb = f.read()
-            cmd_send(ser, fb)
+            cmd_send(ser, load_frame(sys.argv[2]))
 
         elif command == "write":
             cmd_write(ser)
@@ -134,10 +684,57 @@ def main():
             if len(sys.argv) < 3:
                 print("Error: show requires a binary file argument")
                 sys.exit(1)
-            with open(sys.argv[2], "rb") as f:
+            cmd_show(ser, load_frame(sys.argv[2]))
+
+        elif command == "hash":
+            shown, buffer = cmd_hash(ser)
+            fmt = lambda h: "unknown" if h is None else f"{h:08x}"
+            print(f"shown : {fmt(shown)}")
+            print(f"buffer: {fmt(buffer)}")
+            if len(sys.argv) >= 3:
+                print(f"file  : {frame_hash(load_frame(sys.argv[2])):08x}")
+
+        elif command == "text":
+            attrs, cells = text_layout(sys.argv[2:])
+            cmd_text_map(ser, attrs, cells)
+            cmd_text_write(ser)
+
+        elif command == "compose":
+            if len(sys.argv) < 8:
+                print("Error: compose requires <bg> <file.bin> <col> <y> <w> <h>")
+                sys.exit(1)
+            with open(sys.argv[3], "rb") as f:
                 fb = f.read()
-            cmd_send(ser, fb)
-            cmd_write(ser)
+            col, y, w, h = (int(a, 0) for a in sys.argv[4:8])
+            cmd_background(ser, int(sys.argv[2], 0))
+            cmd_overlays(ser, [overlay_from_frame(fb, col, y, w, h)])
+            cmd_compose(ser)
+
+        elif command == "update":
+            if len(sys.argv) < 3:
+                print("Error: update requires a binary file argument")
+                sys.exit(1)
+            previous = load_frame(sys.argv[3]) if len(sys.argv) >= 4 else None
+            cmd_update(ser, load_frame(sys.argv[2]), previous)
+
+        elif command == "spi":
+            info = cmd_spi(ser, calibrate=sys.argv[2:3] == ["cal"])
+            print(f"clock    : {info['khz']} kHz (rate {info['rate']})")
+            print(f"state    : {info['state']}")
+            print(f"passed   : {info['passed']:04b}")
+            print(f"revision : {info['revision']}")
+            print(f"status   : 0x{info['status']:02x}")
+
+        elif command == "seq":
+            if len(sys.argv) < 3:
+                print("Error: seq requires a sequence file or 'default'")
+                sys.exit(1)
+            if sys.argv[2] == "default":
+                data = b""
+            else:
+                with open(sys.argv[2]) as f:
+                    data = seq_assemble(f.read())
+            cmd_epd_seq(ser, data)
 
         else:
             print(f"Unknown command: {command}")
@@ -0,0 +1,302 @@
+#ifdef LINK
+
+/* -----------------------------------------------------------------------
+ * 802.15.4 link: fragmentation, reassembly and retransmission of the
+ * command stream, see link.h
+ *
+ * Must stay in the common area: the transport functions are called
+ * through pointers.
+ * ----------------------------------------------------------------------- */
+#include <cc2530.h>
+#include <stdint.h>
+#include "link.h"
+#include "uart.h"
+#include "sched.h"
+#include "systime.h"
+
+#define LINK_ACK_DUE   0x01    /* send an ack even without data */
+#define LINK_WIN_SHUT  0x02    /* advertised less than a frame of room */
+#define LINK_RTO       0x04    /* retransmit timer running */
+
+/* Offsets in a frame, PHR at 0 */
+#define F_FCF      1
+#define F_MAC_SEQ  3
+#define F_PAN      4
+#define F_DST      6
+#define F_SRC      8
+#define F_FLAGS    10
+#define F_SEQ      11
+#define F_ACK      13
+#define F_WIN      15
+#define F_DATA     16
+
+#define FCF_LO     0x41        /* data frame, PAN ID compression */
+#define FCF_HI     0x88        /* short destination and source */
+#define FCS_CRC_OK 0x80        /* last byte in the RX FIFO */
+
+#define RX_FREE()  ((uint8_t)(rx_tail - rx_head - 1))
+
+__xdata uint8_t link_rx_frame[1 + LINK_MPDU_MAX];
+static __xdata uint8_t tx_frame[1 + LINK_MPDU_MAX];
+
+/* Reassembled stream for the protocol. 8-bit indices wrap by themselves. */
+static __xdata uint8_t rx_ring[LINK_RING];
+static uint8_t  rx_head, rx_tail;
+static uint16_t rx_next;               /* stream offset expected next */
+
+/* Replies, kept from tx_tail until acknowledged */
+static __xdata uint8_t tx_ring[LINK_RING];
+static uint8_t  tx_head, tx_tail;
+static uint8_t  tx_sent;               /* in flight from tx_tail */
+static uint16_t tx_base;               /* stream offset of tx_tail */
+
+static uint8_t  peer_win;
+static uint8_t  mac_seq;
+static uint8_t  retries;
+static uint8_t  link_flags;
+
+static uint16_t get16(__xdata uint8_t *p)
+{
+    return p[0] | ((uint16_t)p[1] << 8);
+}
+
+static void put16(__xdata uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = v >> 8;
+}
+
+/* -----------------------------------------------------------------------
+ * Transport
+ * ----------------------------------------------------------------------- */
+static uint8_t link_ready(void) NONBANKED
+{
+    return rx_head != rx_tail;
+}
+
+static uint8_t link_peek(void) NONBANKED
+{
+    return rx_ring[rx_tail];
+}
+
+/* Reopening a shut window needs an ack, the host would wait for it */
+static uint8_t link_getc(void) NONBANKED
+{
+    uint8_t b = rx_ring[rx_tail++];
+
+    if ((link_flags & LINK_WIN_SHUT) && RX_FREE() >= LINK_DATA_MAX) {
+        link_flags = (link_flags & ~LINK_WIN_SHUT) | LINK_ACK_DUE;
+        SCHED_POST(EV_LINK);
+    }
+    return b;
+}
+
+/* Sent from link_run(), so the bytes of one reply share a frame. A full
+ * ring drops the byte: the host is not reading and will time out. */
+static void link_putb(uint8_t b) NONBANKED
+{
+    if ((uint8_t)(tx_head + 1) != tx_tail)
+        tx_ring[tx_head++] = b;
+    SCHED_POST(EV_LINK);
+}
+
+__code const transport_t link_transport = {
+    link_ready, link_peek, link_getc, link_putb
+};
+
+/* -----------------------------------------------------------------------
+ * Frames out: everything unsent that the host has room for, then an
+ * ack if one is still due
+ * ----------------------------------------------------------------------- */
+static void link_send(uint8_t flags)
+{
+    __xdata uint8_t *p = tx_frame;
+    uint8_t n, i, room;
+
+    while (1) {
+        n    = (uint8_t)(tx_head - tx_tail) - tx_sent;
+        room = peer_win > tx_sent ? peer_win - tx_sent : 0;
+        if (n > room)
+            n = room;
+        if (n > LINK_DATA_MAX)
+            n = LINK_DATA_MAX;
+        if (!n && !(link_flags & LINK_ACK_DUE))
+            return;
+
+        p[0]         = LINK_MHR_LEN + LINK_HDR_LEN + n + LINK_FCS_LEN;
+        p[F_FCF]     = FCF_LO;
+        p[F_FCF + 1] = FCF_HI;
+        p[F_MAC_SEQ] = mac_seq++;
+        put16(p + F_PAN, LINK_PAN_ID);
+        put16(p + F_DST, LINK_HOST_ADDR);
+        put16(p + F_SRC, LINK_ADDR);
+        p[F_FLAGS]   = flags;
+        put16(p + F_SEQ, tx_base + tx_sent);
+        put16(p + F_ACK, rx_next);
+        p[F_WIN]     = RX_FREE();
+        for (i = 0; i < n; i++)
+            p[F_DATA + i] = tx_ring[(uint8_t)(tx_tail + tx_sent + i)];
+        p[F_DATA + n]     = 0;             /* FCS, filled in by the radio */
+        p[F_DATA + n + 1] = 0;
+
+        if (p[F_WIN] < LINK_DATA_MAX)
+            link_flags |= LINK_WIN_SHUT;
+        link_flags &= ~LINK_ACK_DUE;
+        tx_sent += n;
+        phy_send(p);
+
+        if (n && !(link_flags & LINK_RTO)) {
+            link_flags |= LINK_RTO;
+            sched_timer_start(EV_LINK, SYSTIME_MS(LINK_RTO_MS));
+        }
+    }
+}
+
+/* -----------------------------------------------------------------------
+ * Frame in, from the PHY
+ * ----------------------------------------------------------------------- */
+void link_input(void)
+{
+    __xdata uint8_t *p = link_rx_frame;
+    uint8_t  len = p[0];
+    uint8_t  n, i, reply = 0;
+    uint16_t acked;
+
+    if (len < LINK_MHR_LEN + LINK_HDR_LEN + LINK_FCS_LEN ||
+        len > LINK_MPDU_MAX || !(p[len] & FCS_CRC_OK))
+        return;
+    if (p[F_FCF] != FCF_LO || p[F_FCF + 1] != FCF_HI ||
+        get16(p + F_PAN) != LINK_PAN_ID || get16(p + F_DST) != LINK_ADDR)
+        return;
+
+    if (p[F_FLAGS] & LINK_SYN) {
+        rx_next  = get16(p + F_SEQ);
+        tx_base += (uint8_t)(tx_head - tx_tail);
+        tx_tail  = tx_head;
+        tx_sent  = 0;
+        link_flags |= LINK_ACK_DUE;
+        reply = LINK_SYN;
+    }
+
+    /* The ack, if it covers bytes in flight */
+    acked = get16(p + F_ACK) - tx_base;
+    if (acked && acked <= tx_sent) {
+        tx_tail += (uint8_t)acked;
+        tx_base += acked;
+        tx_sent -= (uint8_t)acked;
+        link_flags &= ~LINK_RTO;
+        if (tx_sent) {
+            link_flags |= LINK_RTO;
+            sched_timer_start(EV_LINK, SYSTIME_MS(LINK_RTO_MS));
+        }
+    }
+    peer_win = p[F_WIN];
+    retries  = 0;
+
+    /* Data: only the next in order and only whole, else ack where the
+     * stream stands so the host goes back there */
+    n = len - (LINK_MHR_LEN + LINK_HDR_LEN + LINK_FCS_LEN);
+    if (n) {
+        if (get16(p + F_SEQ) == rx_next && n <= RX_FREE()) {
+            for (i = 0; i < n; i++)
+                rx_ring[rx_head++] = p[F_DATA + i];
+            rx_next += n;
+            SCHED_POST(EV_RX);
+        }
+        link_flags |= LINK_ACK_DUE;
+    }
+    link_send(reply);
+}
+
+/* EV_LINK: received frames, replies to send and the retransmit timer.
+ * The timer may still run after its data was acked; LINK_RTO says
+ * whether it counts. */
+static void link_run(void) NONBANKED
+{
+    phy_run();
+
+    if ((link_flags & LINK_RTO) && !sched_timer_armed(EV_LINK)) {
+        link_flags &= ~LINK_RTO;
+        tx_sent = 0;                       /* go back to the oldest unacked */
+        retries++;
+    }
+    if (retries > LINK_RETRIES)
+        return;                            /* until the host is heard from */
+    link_send(0);
+}
+
+void link_init(void)
+{
+    rx_head = rx_tail = 0;
+    rx_next = 0;
+    tx_head = tx_tail = 0;
+    tx_sent = 0;
+    tx_base = 0;
+    peer_win   = 0;                        /* nothing until the host's SYN */
+    retries    = 0;
+    link_flags = 0;
+    phy_init();
+    sched_on(EV_LINK, link_run);
+}
+
+#ifdef LINK_LOOPBACK
+/* -----------------------------------------------------------------------
+ * UART tunnel instead of the radio: 0x4D, PHR, MPDU
+ * ----------------------------------------------------------------------- */
+#define TUN_SYNC  0
+#define TUN_PHR   1
+#define TUN_MPDU  2
+
+static uint8_t tun_state;
+static uint8_t tun_pos;
+
+/* From proto_run() on EV_RX, the UART's bytes are all tunnel */
+void link_tunnel_rx(void) NONBANKED
+{
+    uint8_t b;
+
+    while (uart_rx_ready()) {
+        b = uart_getc();
+        switch (tun_state) {
+        case TUN_SYNC:
+            if (b == LINK_TUNNEL)
+                tun_state = TUN_PHR;
+            break;
+
+        case TUN_PHR:
+            link_rx_frame[0] = b;
+            tun_pos   = 1;
+            tun_state = b && b <= LINK_MPDU_MAX ? TUN_MPDU : TUN_SYNC;
+            break;
+
+        case TUN_MPDU:
+            link_rx_frame[tun_pos++] = b;
+            if (tun_pos > link_rx_frame[0]) {
+                tun_state = TUN_SYNC;
+                link_input();
+            }
+            break;
+        }
+    }
+}
+
+void phy_init(void)
+{
+    tun_state = TUN_SYNC;
+}
+
+void phy_send(__xdata uint8_t *frame)
+{
+    uint8_t i;
+
+    uart_putb(LINK_TUNNEL);
+    for (i = 0; i <= frame[0]; i++)
+        uart_putb(frame[i]);
+}
+
+void phy_run(void)
+{
+}
+#endif /* LINK_LOOPBACK */
+
+#endif /* LINK */
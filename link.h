@@ -0,0 +1,79 @@
+#ifndef LINK_H
+#define LINK_H
+
+#include <cc2530.h>
+#include <stdint.h>
+#include "bank.h"
+#include "transport.h"
+
+/*
+ * Command stream over IEEE 802.15.4 (make LINK=radio or LINK=loopback)
+ *
+ * The protocol bytes are cut into data frames, short addresses with PAN
+ * ID compression and no MAC acknowledgement:
+ *
+ *   PHR  FCF 41 88  mac seq  PAN  dst  src | flags seq16 ack16 win | data | FCS
+ *
+ * seq16 is the stream offset of the first data byte, ack16 the offset
+ * of the next byte expected from the peer, win the free bytes in the
+ * sender's RX ring. Every frame carries an ack; one without data is
+ * just that. LINK_SYN starts a session: the receiver takes seq16 as the
+ * peer's stream start, drops what it had not got acknowledged and
+ * answers with LINK_SYN and its own stream offset.
+ *
+ * Go-back-N: the tag takes only the frame at its ack16 and answers
+ * every data frame with an ack, so a gap makes the host resend from
+ * there. The host may have win bytes unacknowledged. The tag resends
+ * its own after LINK_RTO_MS, up to LINK_RETRIES times; then it sends
+ * nothing, new replies and window updates included, until the next
+ * frame from the host.
+ *
+ * LINK=radio sends the frames with the CC2530 radio (radio.c).
+ * LINK=loopback tunnels them over the UART instead, as
+ *   0x4D, PHR, MPDU
+ * with the FCS as the radio would leave it in the RX FIFO (RSSI, then
+ * bit7 CRC OK), so the fragmentation and windowing run without RF
+ * hardware (host_script/radio_link.py --loss). The UART then carries
+ * nothing else.
+ */
+#ifndef LINK_PAN_ID
+#define LINK_PAN_ID      0xE1AB
+#endif
+#ifndef LINK_ADDR
+#define LINK_ADDR        0x0001        /* this tag */
+#endif
+#define LINK_HOST_ADDR   0x0000
+#ifndef LINK_CHANNEL
+#define LINK_CHANNEL     25            /* 2475 MHz, between Wi-Fi 6 and 11 */
+#endif
+
+#define LINK_MPDU_MAX    127
+#define LINK_MHR_LEN     9
+#define LINK_FCS_LEN     2
+#define LINK_HDR_LEN     6
+#define LINK_DATA_MAX    (LINK_MPDU_MAX - LINK_MHR_LEN - LINK_HDR_LEN - LINK_FCS_LEN)
+#define LINK_RING        256
+#define LINK_RTO_MS      40
+#define LINK_RETRIES     8
+#define LINK_TUNNEL      0x4D
+
+#define LINK_SYN         0x01          /* flags */
+
+/* PHR + MPDU as in the RX FIFO, handed over by the PHY */
+extern __xdata uint8_t link_rx_frame[1 + LINK_MPDU_MAX];
+
+void link_init(void);
+void link_input(void);                 /* link_rx_frame holds a frame */
+void link_tunnel_rx(void) NONBANKED;   /* LINK_LOOPBACK: UART to frames */
+
+/* PHY, radio.c or the UART tunnel in link.c */
+void phy_init(void);
+void phy_send(__xdata uint8_t *frame);  /* PHR + MPDU, FCS filled in */
+void phy_run(void);                     /* EV_LINK */
+
+#ifdef LINK_RADIO
+/* ISR prototype must be visible in main.c for the vector table */
+void radio_isr(void) __interrupt(RF_VECTOR);
+#endif
+
+#endif /* LINK_H */
@@ -21,6 +21,10 @@
 #include "epd_busy.h"
 #include "GxGDEW0213Z16.h"
 #include "uart_rx.h"
+#include "text.h"
+#include "sched.h"
+#include "temp.h"
+#include "link.h"
 
 /* -----------------------------------------------------------------------
  * Clock
@@ -36,9 +40,6 @@ static void clock_init(void)
  * ----------------------------------------------------------------------- */
 void main(void)
 {
-    uint8_t  i;
-    uint16_t counter = 0;
-
     clock_init();
     wdt_init();
     uart_init();
@@ -49,6 +50,7 @@ void main(void)
     uart_puts("CC2530 UART ready\n");
     uart_printf("Chip ID : 0x%04x\n", (uint16_t)CHIPID);
     uart_printf("ClkConSta: 0x%02x\n", (uint16_t)CLKCONSTA);
+    uart_printf("Temp    : %d C\n", (int16_t)temp_read());
 
     /* Stack pointer is SFR SP (0x81). SDCC initialises it to 0x3F.
      * It grows UP toward 0xFF. Past 0xFF it silently wraps into SFR
@@ -59,29 +61,18 @@ void main(void)
 
     uart_puts("Counting...\n");
 
+    /* Everything from here on runs from sched_run(): the panel powers
+     * up while the first command arrives */
+    sched_init();
     EPD_Init();
+    text_clear();
+    uart_rx_init();
+#ifdef LINK
+    link_init();
+#endif
     // EPD_Test();
 
     // EPD_Clear();
 
-    while (1)
-    {
-        uart_process_command();
-
-        // uart_puts("hello world\n");
-        // counter++;
-
-        // /* print SP every 16 iters to watch for stack creep */
-        // if ((counter & 0x0F) == 0)
-        //     uart_printf("[%u] SP=0x%02x headroom=%u\n",
-        //                 counter, (uint16_t)SP, (uint16_t)(0xFF - SP));
-
-        // WDT_FEED();
-
-        for (i = 0; i < 200; i++) {
-            uint16_t j;
-            for (j = 0; j < 535; j++);
-            WDT_FEED();
-        }
-    }
+    sched_run();   /* feeds the watchdog, idles the CPU between events */
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+#ifdef LINK_RADIO
+
+/* -----------------------------------------------------------------------
+ * 802.15.4 PHY for link.c on the CC2530 radio
+ *
+ * The radio appends and checks the FCS (AUTOCRC) and drops frames for
+ * other PANs and addresses (frame filtering); link.c sends its own acks,
+ * so AUTOACK is off. Frames move between the FIFOs and RAM by DMA:
+ * channel 1 copies a received frame out of RFD, its length from the
+ * PHR (VLEN), channel 2 fills the TX FIFO.
+ *
+ * The RX FIFO holds 128 bytes, one full frame. The RF interrupt only
+ * counts finished frames and posts EV_LINK; phy_run() copies them out.
+ * ----------------------------------------------------------------------- */
+#include <cc2530.h>
+#include <stdint.h>
+#include "link.h"
+#include "dma.h"
+#include "sched.h"
+
+#define RFD_XADDR       0x70D9      /* RFD seen from XDATA, for the DMA */
+
+/* RFST command strobes */
+#define ISRXON          0xE3
+#define ISTXON          0xE9
+#define ISFLUSHRX       0xED
+#define ISFLUSHTX       0xEE
+
+#define RF_RXPKTDONE    0x40        /* RFIRQF0, RFIRQM0 */
+#define RF_TXDONE       0x02        /* RFIRQF1 */
+#define RF_RXOVERF      0x04        /* RFERRF */
+
+static __xdata dma_desc_t rf_dma[4];   /* channels 1-4, only 1 and 2 used */
+static volatile __data uint8_t rf_rx_frames;
+static uint8_t rf_tx_busy;
+
+/* No locals, see fb.h */
+void radio_isr(void) __interrupt(RF_VECTOR)
+{
+    S1CON = 0;
+    if (RFIRQF0 & RF_RXPKTDONE) {
+        RFIRQF0 = ~RF_RXPKTDONE;            /* write 0 clears */
+        rf_rx_frames++;
+        SCHED_POST(EV_LINK);
+    }
+}
+
+static void rf_dma_run(uint8_t ch)
+{
+    DMAARM = DMA_CH(ch);
+    __asm                                   ; 9 clocks to load the descriptor
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+    __endasm;
+    DMAREQ = DMA_CH(ch);
+    while (DMAARM & DMA_CH(ch));
+}
+
+static void rf_flush_rx(void)
+{
+    RFST = ISFLUSHRX;                       /* twice, per the user's guide */
+    RFST = ISFLUSHRX;
+    rf_rx_frames = 0;
+}
+
+void phy_init(void)
+{
+    __xdata dma_desc_t *d;
+
+    /* Recommended values that differ from the reset ones */
+    AGCCTRL1  = 0x15;
+    TXFILTCFG = 0x09;
+    FSCAL1    = 0x00;
+
+    FRMCTRL0  = 0x40;                       /* AUTOCRC */
+    FRMFILT0  = 0x0D;                       /* filter: PAN, short address */
+    FREQCTRL  = 11 + 5 * (LINK_CHANNEL - 11);
+    TXPOWER   = 0xD5;                       /* +1 dBm */
+    PAN_ID0     = (uint8_t)LINK_PAN_ID;
+    PAN_ID1     = LINK_PAN_ID >> 8;
+    SHORT_ADDR0 = (uint8_t)LINK_ADDR;
+    SHORT_ADDR1 = LINK_ADDR >> 8;
+
+    /* Channel 1: RFD -> link_rx_frame, PHR + 1 bytes */
+    d = &rf_dma[0];
+    d->srch = RFD_XADDR >> 8;
+    d->srcl = (uint8_t)RFD_XADDR;
+    d->dsth = (uint16_t)link_rx_frame >> 8;
+    d->dstl = (uint8_t)(uint16_t)link_rx_frame;
+    d->lenh = DMA_VLEN_FIRST;
+    d->lenl = 1 + LINK_MPDU_MAX;
+    d->trig = DMA_BLOCK;
+    d->mode = DMA_DST_INC | DMA_PRI_HIGH;
+
+    /* Channel 2: frame -> RFD, source and length set per frame */
+    d = &rf_dma[1];
+    d->dsth = RFD_XADDR >> 8;
+    d->dstl = (uint8_t)RFD_XADDR;
+    d->trig = DMA_BLOCK;
+    d->mode = DMA_SRC_INC | DMA_PRI_HIGH;
+
+    DMA1CFGH = (uint16_t)rf_dma >> 8;
+    DMA1CFGL = (uint8_t)(uint16_t)rf_dma;
+
+    rf_tx_busy = 0;
+    rf_flush_rx();
+    RFIRQF0  = 0;
+    RFIRQM0 |= RF_RXPKTDONE;
+    IEN2    |= 0x01;                        /* RFIE */
+    RFST     = ISRXON;
+}
+
+/* EV_LINK, from link_run() */
+void phy_run(void)
+{
+    if (RFERRF & RF_RXOVERF) {              /* FIFO out of step, start over */
+        RFERRF &= ~RF_RXOVERF;
+        rf_flush_rx();
+        return;
+    }
+    while (rf_rx_frames) {
+        rf_dma_run(1);
+        rf_rx_frames--;                     /* single dec, safe vs. the ISR */
+        link_input();
+    }
+}
+
+/* Waits for the previous frame, up to ~4 ms for 127 bytes at 250 kbit/s;
+ * replies are short and rare, so the event loop can afford it */
+void phy_send(__xdata uint8_t *frame)
+{
+    __xdata dma_desc_t *d = &rf_dma[1];
+    uint8_t len = frame[0] + 1 - 2;         /* the radio adds the FCS */
+
+    if (rf_tx_busy)
+        while (!(RFIRQF1 & RF_TXDONE));
+    RFIRQF1 = ~RF_TXDONE;
+    RFST    = ISFLUSHTX;
+
+    d->srch = (uint16_t)frame >> 8;
+    d->srcl = (uint8_t)(uint16_t)frame;
+    d->lenh = 0;
+    d->lenl = len;
+    rf_dma_run(2);
+
+    RFST = ISTXON;
+    rf_tx_busy = 1;
+}
+
+#endif /* LINK_RADIO */
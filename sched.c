@@ -0,0 +1,175 @@
+/* -----------------------------------------------------------------------
+ * Cooperative scheduler, see sched.h
+ *
+ * Must stay in the common area: ISRs, and sched_run() calls the
+ * handlers through pointers.
+ * ----------------------------------------------------------------------- */
+#include <cc2530.h>
+#include <stdint.h>
+#include "sched.h"
+#include "systime.h"
+#include "wdt.h"
+
+#define SCHED_EVENTS      8
+#define SCHED_MIN_TICKS   3          /* closer compares may be missed */
+#define SYSTIME_MASK      0x00FFFFFFUL
+#define SYSTIME_HALF      0x00800000UL
+
+volatile __data uint8_t sched_pending;
+
+static sched_fn handlers[SCHED_EVENTS];
+static uint32_t deadline[SCHED_EVENTS];
+static uint8_t  timers;              /* armed timers, one bit per event */
+
+/* -----------------------------------------------------------------------
+ * Interrupts, kept to posting events
+ * ----------------------------------------------------------------------- */
+void sched_st_isr(void) __interrupt(ST_VECTOR)
+{
+    STIF = 0;
+    SCHED_POST(EV_TIMER);
+}
+
+/* P1_2 (EPD BUSY, epd_busy.h) is the only port 1 interrupt */
+void sched_p1_isr(void) __interrupt(P1INT_VECTOR)
+{
+    P1IFG = 0;
+    P1IF  = 0;
+    SCHED_POST(EV_EPD_BUSY);
+}
+
+/* -----------------------------------------------------------------------
+ * Timers
+ * ----------------------------------------------------------------------- */
+static uint8_t ev_index(uint8_t ev)
+{
+    uint8_t i = 0;
+    while (!(ev & 1)) {
+        ev >>= 1;
+        i++;
+    }
+    return i;
+}
+
+/* Sleep timer compare: write ST2, ST1, then ST0, which loads all three */
+static void st_compare(uint32_t t)
+{
+    while (!(STLOAD & 0x01));
+    ST2 = (uint8_t)(t >> 16);
+    ST1 = (uint8_t)(t >> 8);
+    ST0 = (uint8_t)t;
+}
+
+/* Program the compare for the earliest deadline, or the heartbeat */
+static void sched_arm(void)
+{
+    uint32_t now  = systime_now();
+    uint32_t next = SYSTIME_MS(SCHED_MAX_SLEEP_MS);
+    uint32_t left;
+    uint8_t  i;
+
+    for (i = 0; i < SCHED_EVENTS; i++) {
+        if (!(timers & (1 << i)))
+            continue;
+        left = (deadline[i] - now) & SYSTIME_MASK;
+        if (left >= SYSTIME_HALF)            /* already passed */
+            left = 0;
+        if (left < next)
+            next = left;
+    }
+
+    if (next < SCHED_MIN_TICKS)
+        SCHED_POST(EV_TIMER);
+    else
+        st_compare((now + next) & SYSTIME_MASK);
+}
+
+static void timers_run(void)
+{
+    uint32_t now = systime_now();
+    uint8_t  i, ev;
+
+    for (i = 0; i < SCHED_EVENTS; i++) {
+        ev = 1 << i;
+        if ((timers & ev) &&
+            ((now - deadline[i]) & SYSTIME_MASK) < SYSTIME_HALF) {
+            timers &= ~ev;
+            SCHED_POST(ev);
+        }
+    }
+    sched_arm();
+}
+
+void sched_timer_start(uint8_t ev, uint32_t ticks)
+{
+    deadline[ev_index(ev)] = (systime_now() + ticks) & SYSTIME_MASK;
+    timers |= ev;
+    sched_arm();
+}
+
+/* Also drops an expiry that was posted but has not run yet */
+void sched_timer_stop(uint8_t ev)
+{
+    timers &= ~ev;
+    sched_pending &= ~ev;
+}
+
+uint8_t sched_timer_armed(uint8_t ev)
+{
+    return (timers & ev) != 0;
+}
+
+/* -----------------------------------------------------------------------
+ * Event loop
+ * ----------------------------------------------------------------------- */
+void sched_init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < SCHED_EVENTS; i++)
+        handlers[i] = 0;
+    timers        = 0;
+    sched_pending = 0;
+
+    STIF  = 0;
+    STIE  = 1;
+    sched_arm();
+}
+
+void sched_on(uint8_t ev, sched_fn fn)
+{
+    handlers[ev_index(ev)] = fn;
+}
+
+/* Enables interrupts and never returns */
+void sched_run(void)
+{
+    uint8_t ev, i;
+
+    EA = 1;
+    while (1) {
+        WDT_FEED();
+
+        ev = sched_pending;
+        if (!ev) {
+            /* An interrupt is not taken in the instruction after setb EA,
+             * so one arriving after the check still wakes the idle */
+            EA = 0;
+            if (!sched_pending) {
+                EA = 1;
+                PCON |= 0x01;                /* PM0 idle until an interrupt */
+            }
+            EA = 1;
+            continue;
+        }
+
+        i  = ev_index(ev);
+        ev = 1 << i;
+        sched_pending &= ~ev;
+
+        if (ev == EV_TIMER)
+            timers_run();
+        else if (handlers[i])
+            handlers[i]();
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <cc2530.h>
+#include <stdint.h>
+#include "bank.h"
+
+/*
+ * Cooperative run-to-completion scheduler
+ *
+ * Work is split into handlers that never block. ISRs and handlers post
+ * events, one bit each in sched_pending, so an event posted twice before
+ * it runs is handled once. sched_run() calls the handler of the lowest
+ * pending bit, i.e. the list below is in priority order: RX first so
+ * the RX rings drain while the panel is fed. With nothing pending the
+ * CPU idles (PM0) until the next interrupt.
+ *
+ * Timers: sched_timer_start(ev, ticks) posts ev after ticks of the
+ * 32.768 kHz sleep timer (SYSTIME_MS()). One timer per event bit.
+ * The sleep timer compare interrupt is programmed for the earliest
+ * deadline, at most SCHED_MAX_SLEEP_MS ahead so the watchdog is fed.
+ *
+ * Handlers are called through a pointer: NONBANKED, see bank.h.
+ */
+#define EV_RX          0x01   /* bytes for the protocol (transport.h) */
+#define EV_EPD_BUSY    0x02   /* P1_2 rising edge: panel no longer busy */
+#define EV_EPD_TIMER   0x04   /* EPD delay, BUSY timeout or idle timer */
+#define EV_EPD_STEP    0x08   /* EPD: send the next rows */
+#define EV_EPD_SENT    0x10   /* EPD: frame sent, its sources are free */
+#define EV_EPD_DONE    0x20   /* EPD: refresh complete */
+#define EV_LINK        0x40   /* link.c: frames received, replies to send,
+                                 retransmit timer (link.h) */
+#define EV_TIMER       0x80   /* sleep timer compare, internal */
+
+#define SCHED_MAX_SLEEP_MS  250
+
+typedef void (*sched_fn)(void) NONBANKED;
+
+/* In __data: |= and &= on it are single instructions, safe vs. ISRs */
+extern volatile __data uint8_t sched_pending;
+
+#define SCHED_POST(ev)  (sched_pending |= (ev))
+
+void sched_init(void);
+void sched_on(uint8_t ev, sched_fn fn);
+void sched_run(void);
+
+void sched_timer_start(uint8_t ev, uint32_t ticks);
+void sched_timer_stop(uint8_t ev);
+uint8_t sched_timer_armed(uint8_t ev);
+
+/* ISR prototypes must be visible in main.c for the vector table */
+void sched_st_isr(void) __interrupt(ST_VECTOR);
+void sched_p1_isr(void) __interrupt(P1INT_VECTOR);
+
+#endif /* SCHED_H */
@@ -0,0 +1,469 @@
+/*
+ * board.cpp — the CC2530 as far as the firmware uses it
+ *
+ * Clock: a queue of timed events (bit edges, sleep timer compare, BUSY
+ * released) and sim_now, which advances by --cpu-ns on every SFR access
+ * and by the ADC, which blocks for its 132 us. SPI and UART bytes are
+ * shifted out as bit events while the firmware polls their flags. PCON
+ * idle jumps to the next event.
+ *
+ * Pins are worked out from the port latches, P0SEL/P1SEL and
+ * P0DIR/P1DIR as the firmware sets them, so a pin only toggles when
+ * the firmware has routed something to it; every change goes to the
+ * trace and to the panel.
+ */
+#include <stdio.h>
+#include <math.h>
+#include <queue>
+#include <vector>
+#include "sim.h"
+#include "board.h"
+#include "temp.h"
+
+uint8_t sim_sfr[SIM_REG_COUNT];
+sim_ns  sim_now;
+
+/* The firmware's interrupt handlers */
+void uart_rx_isr(void);
+void sched_st_isr(void);
+void sched_p1_isr(void);
+
+#define HOST_POLL_NS   SIM_US(100)    /* pty read while the CPU is busy */
+#define HOST_WAIT_MS   20             /* real time, while the CPU idles */
+#define IDLE_MAX_NS    SIM_MS(1000)   /* nothing queued at all */
+#define ADC_CONV_NS    SIM_US(132)    /* 512 decimation: (512 + 16) / 4 MHz */
+#define UART_DEF_BAUD  921600         /* before uart_init() */
+
+/* ---- events ----------------------------------------------------------- */
+struct event {
+    sim_ns   t;
+    uint64_t seq;                     /* FIFO among equal times */
+    std::function<void()> fn;
+};
+
+struct event_later {
+    bool operator()(const event &a, const event &b) const
+    {
+        return a.t != b.t ? a.t > b.t : a.seq > b.seq;
+    }
+};
+
+static std::priority_queue<event, std::vector<event>, event_later> events;
+static uint64_t event_seq;
+static sim_ns   next_poll;
+
+void board_at(sim_ns t, std::function<void()> fn)
+{
+    events.push({ t, event_seq++, fn });
+}
+
+/* Run the events up to t and move the clock there */
+static void run_until(sim_ns t)
+{
+    while (!events.empty() && events.top().t <= t) {
+        event e = events.top();
+        events.pop();
+        if (e.t > sim_now)
+            sim_now = e.t;
+        e.fn();
+    }
+    if (t > sim_now)
+        sim_now = t;
+
+    if (sim_now >= next_poll) {
+        next_poll = sim_now + HOST_POLL_NS;
+        host_poll(0);
+    }
+}
+
+/* ---- pins ------------------------------------------------------------- */
+static uint8_t pin_level[PIN_COUNT];
+static uint8_t pin_ext[PIN_COUNT];    /* driven from outside the chip */
+static uint8_t spi_sck, spi_mosi;     /* USART0 outputs */
+static uint8_t uart_tx = 1;           /* USART1 output */
+
+static uint8_t port_pin(uint8_t port, uint8_t sel, uint8_t dir, uint8_t bit,
+                        uint8_t periph, uint8_t outside)
+{
+    if (!((sim_sfr[dir] >> bit) & 1))
+        return outside;
+    if ((sim_sfr[sel] >> bit) & 1)
+        return periph;
+    return (sim_sfr[port] >> bit) & 1;
+}
+
+static uint8_t pin_compute(int pin)
+{
+    switch (pin) {
+    case PIN_CS:   return port_pin(SIM_P0, SIM_P0SEL, SIM_P0DIR, 4, 1, 1);
+    case PIN_DC:   return port_pin(SIM_P0, SIM_P0SEL, SIM_P0DIR, 2, 1, 1);
+    case PIN_SCK:  return port_pin(SIM_P0, SIM_P0SEL, SIM_P0DIR, 5, spi_sck, 0);
+    case PIN_SDA:  return port_pin(SIM_P0, SIM_P0SEL, SIM_P0DIR, 3, spi_mosi,
+                                   pin_ext[PIN_SDA]);
+    case PIN_RST:  return port_pin(SIM_P1, SIM_P1SEL, SIM_P1DIR, 1, 1, 1);
+    case PIN_BUSY: return pin_ext[PIN_BUSY];
+    case PIN_TX:   return port_pin(SIM_P1, SIM_P1SEL, SIM_P1DIR, 6, uart_tx, 1);
+    case PIN_RX:   return pin_ext[PIN_RX];
+    }
+    return 1;
+}
+
+/* One pin at a time: the panel may drive another one in panel_pin() */
+static void pins_update(void)
+{
+    uint8_t v;
+    int p;
+
+    for (p = 0; p < PIN_COUNT; p++) {
+        v = pin_compute(p);
+        if (v == pin_level[p])
+            continue;
+        pin_level[p] = v;
+        trace_pin(p, v);
+
+        /* P1_2 rising edge (PICTL bit1 clear), epd_busy.h */
+        if (p == PIN_BUSY && v && (sim_sfr[SIM_P1IEN] & 0x04) &&
+            !(sim_sfr[SIM_PICTL] & 0x02)) {
+            sim_sfr[SIM_P1IFG] |= 0x04;
+            sim_sfr[SIM_IRCON2] |= 0x08;
+        }
+        panel_pin(p, v);
+    }
+}
+
+uint8_t board_pin(int pin)
+{
+    return pin_level[pin];
+}
+
+void board_drive(int pin, uint8_t level)
+{
+    pin_ext[pin] = level;
+    pins_update();
+}
+
+/* Inputs as the port registers read them */
+static uint8_t port_read(uint8_t reg)
+{
+    uint8_t v = sim_sfr[reg];
+
+    if (reg == SIM_P0 && !(sim_sfr[SIM_P0DIR] & 0x08))
+        v = (v & ~0x08) | (pin_level[PIN_SDA] << 3);
+    if (reg == SIM_P1) {
+        if (!(sim_sfr[SIM_P1DIR] & 0x04))
+            v = (v & ~0x04) | (pin_level[PIN_BUSY] << 2);
+        if (!(sim_sfr[SIM_P1DIR] & 0x80))
+            v = (v & ~0x80) | (pin_level[PIN_RX] << 7);
+    }
+    return v;
+}
+
+/* ---- interrupts ------------------------------------------------------- */
+static bool in_isr;
+static int  irq_hold;                 /* accesses left without interrupts */
+
+/* One priority level, polled in vector order: URX1, ST, P1INT */
+static bool take_irqs(void)
+{
+    bool taken = false;
+
+    if (in_isr || irq_hold || !(sim_sfr[SIM_IEN0] & 0x80))
+        return false;
+
+    in_isr = true;
+    for (;;) {
+        if ((sim_sfr[SIM_TCON] & 0x80) && (sim_sfr[SIM_IEN0] & 0x08))
+            uart_rx_isr();
+        else if ((sim_sfr[SIM_IRCON] & 0x80) && (sim_sfr[SIM_IEN0] & 0x20))
+            sched_st_isr();
+        else if ((sim_sfr[SIM_IRCON2] & 0x08) && (sim_sfr[SIM_IEN2] & 0x10))
+            sched_p1_isr();
+        else
+            break;
+        taken = true;
+    }
+    in_isr = false;
+    return taken;
+}
+
+/* PM0: wait for an interrupt, for the host in real time if nothing is
+ * due soon */
+static void cpu_idle(void)
+{
+    sim_ns next;
+
+    irq_hold = 0;
+    while (!take_irqs()) {
+        next = events.empty() ? sim_now + IDLE_MAX_NS : events.top().t;
+        if (next > sim_now + SIM_MS(1)) {
+            host_poll(HOST_WAIT_MS);
+            if (!events.empty() && events.top().t < next)
+                next = events.top().t;
+        }
+        run_until(next);
+    }
+}
+
+/* ---- USARTs ----------------------------------------------------------- */
+/* (256 + BAUD_M) * 2^BAUD_E / 2^28 * 32 MHz */
+static double usart_hz(uint8_t baud, uint8_t gcr)
+{
+    return (256.0 + baud) * (double)(1UL << (gcr & 0x1F)) / 268435456.0 * 32e6;
+}
+
+/* SPI master, CPOL=0 CPHA=0 MSB first (spi.c). The byte goes out as
+ * events; the firmware polls TX_BYTE meanwhile and takes interrupts. */
+static void spi_shift(uint8_t v)
+{
+    sim_ns half, t = sim_now;
+    int i;
+
+    if (sim_sfr[SIM_U0CSR] & 0x80)            /* UART mode, unused */
+        return;
+    half = (sim_ns)(1e9 / usart_hz(sim_sfr[SIM_U0BAUD], sim_sfr[SIM_U0GCR]) / 2);
+
+    for (i = 7; i >= 0; i--) {
+        board_at(t, [v, i] { spi_mosi = (v >> i) & 1; pins_update(); });
+        board_at(t + half, [] { spi_sck = 1; pins_update(); });
+        t += 2 * half;
+        board_at(t, [] { spi_sck = 0; pins_update(); });
+    }
+    board_at(t, [] {
+        sim_sfr[SIM_U0DBUF] = 0xFF;           /* MISO is not connected */
+        sim_sfr[SIM_U0CSR] |= 0x06;           /* RX_BYTE, TX_BYTE */
+    });
+}
+
+static sim_ns uart_bit_ns(void)
+{
+    double hz = sim_sfr[SIM_U1GCR] & 0x1F ?
+                usart_hz(sim_sfr[SIM_U1BAUD], sim_sfr[SIM_U1GCR]) : UART_DEF_BAUD;
+    return (sim_ns)(1e9 / hz);
+}
+
+/* 8N1, LSB first, then off to the host */
+static void uart_shift(uint8_t v)
+{
+    sim_ns bit = uart_bit_ns();
+    int i;
+
+    if (!(sim_sfr[SIM_U1CSR] & 0x80))
+        return;
+
+    trace_bus(BUS_UART_TX, v);
+    for (i = -1; i <= 8; i++)
+        board_at(sim_now + (i + 1) * bit, [v, i] {
+            uart_tx = i < 0 ? 0 : i == 8 ? 1 : (v >> i) & 1;
+            pins_update();
+        });
+    board_at(sim_now + 10 * bit, [v] {
+        trace_bus(BUS_UART_TX, -1);
+        host_tx(v);
+        sim_sfr[SIM_U1CSR] |= 0x02;           /* TX_BYTE */
+    });
+}
+
+static sim_ns rx_free;                        /* RX line idle from */
+static unsigned rx_overruns;
+
+static void uart_received(uint8_t b)
+{
+    if (!(sim_sfr[SIM_U1CSR] & 0x40))         /* receiver off */
+        return;
+    if (sim_sfr[SIM_U1CSR] & 0x04)
+        rx_overruns++;
+    sim_sfr[SIM_U1DBUF] = b;
+    sim_sfr[SIM_U1CSR] |= 0x04;               /* RX_BYTE */
+    sim_sfr[SIM_TCON]  |= 0x80;               /* URX1IF */
+}
+
+/* A byte from the host, on the line after the ones before it */
+void board_host_byte(uint8_t b)
+{
+    sim_ns bit = uart_bit_ns();
+    sim_ns t   = sim_now > rx_free ? sim_now : rx_free;
+    int i;
+
+    rx_free = t + 10 * bit;
+    board_at(t, [b] { trace_bus(BUS_UART_RX, b); board_drive(PIN_RX, 0); });
+    for (i = 0; i < 8; i++)
+        board_at(t + (i + 1) * bit, [b, i] { board_drive(PIN_RX, (b >> i) & 1); });
+    board_at(t + 9 * bit, [b] { board_drive(PIN_RX, 1); uart_received(b); });
+    board_at(t + 10 * bit, [] { trace_bus(BUS_UART_RX, -1); });
+}
+
+/* Whether the host may hand over more bytes: keeps the rest in the pty,
+ * like a USB-serial adapter sending at the line rate */
+bool board_rx_room(void)
+{
+    return rx_free < sim_now + SIM_MS(1);
+}
+
+/* ---- sleep timer, ADC ------------------------------------------------- */
+static uint8_t  st_load[3];                   /* compare, ST0 written last */
+static unsigned st_gen;
+
+static uint64_t st_ticks(void)
+{
+    return sim_now * 32768 / 1000000000ULL;
+}
+
+static void st_compare(uint8_t st0)
+{
+    uint32_t cmp   = (uint32_t)st_load[2] << 16 | (uint32_t)st_load[1] << 8 | st0;
+    uint64_t now   = st_ticks();
+    uint32_t ahead = (cmp - (uint32_t)now) & 0xFFFFFF;
+    unsigned gen   = ++st_gen;
+
+    if (!ahead)                               /* passed: after a wrap */
+        ahead = 0x1000000;
+    board_at(((now + ahead) * 1000000000ULL + 32767) / 32768, [gen] {
+        if (gen == st_gen)
+            sim_sfr[SIM_IRCON] |= 0x80;       /* STIF */
+    });
+}
+
+/* temp.c in reverse, rounded so that it reads --temp back */
+static void adc_convert(void)
+{
+    int d = (sim_opt.temp_c - TEMP_OFFSET_C - 25) * 9;
+    int v = TEMP_ADC_25C + (d >= 0 ? (d + 1) / 2 : (d - 1) / 2);
+
+    run_until(sim_now + ADC_CONV_NS);
+    v <<= 4;
+    sim_sfr[SIM_ADCL] = v & 0xF0;
+    sim_sfr[SIM_ADCH] = v >> 8;
+    sim_sfr[SIM_ADCCON1] |= 0x80;             /* EOC */
+}
+
+/* ---- SFR access ------------------------------------------------------- */
+uint8_t sim_read(uint8_t reg)
+{
+    uint64_t t;
+    uint8_t  v;
+
+    run_until(sim_now + sim_opt.cpu_ns);
+    switch (reg) {
+    case SIM_P0:
+    case SIM_P1:
+        v = port_read(reg);
+        break;
+    case SIM_ST0:                             /* latches ST1, ST2 */
+        t = st_ticks();
+        sim_sfr[SIM_ST1] = t >> 8;
+        sim_sfr[SIM_ST2] = t >> 16;
+        v = (uint8_t)t;
+        break;
+    case SIM_STLOAD:
+        v = 0x01;
+        break;
+    case SIM_CLKCONSTA:
+        v = sim_sfr[SIM_CLKCONCMD];
+        break;
+    case SIM_ADCH:
+        v = sim_sfr[reg];
+        sim_sfr[SIM_ADCCON1] &= ~0x80;
+        break;
+    case SIM_U1DBUF:
+        v = sim_sfr[reg];
+        sim_sfr[SIM_U1CSR] &= ~0x04;
+        break;
+    default:
+        v = sim_sfr[reg];
+        break;
+    }
+
+    if (irq_hold)
+        irq_hold--;
+    take_irqs();
+    return v;
+}
+
+static void sfr_store(uint8_t reg, uint8_t v)
+{
+    uint8_t old = sim_sfr[reg];
+
+    irq_hold = 0;
+    switch (reg) {
+    case SIM_ST1:
+    case SIM_ST2:
+        st_load[reg == SIM_ST1 ? 1 : 2] = v;
+        break;
+    case SIM_ST0:
+        st_compare(v);
+        break;
+    case SIM_U0DBUF:
+        spi_shift(v);
+        break;
+    case SIM_U1DBUF:
+        uart_shift(v);
+        break;
+    case SIM_U0UCR:
+    case SIM_U1UCR:
+        sim_sfr[reg] = v & 0x7F;              /* FLUSH reads 0 */
+        break;
+    case SIM_ADCCON3:
+        sim_sfr[reg] = v;
+        adc_convert();
+        break;
+    case SIM_PCON:
+        if (v & 0x01)
+            cpu_idle();
+        break;
+    case SIM_IEN0:
+        sim_sfr[reg] = v;
+        /* not taken in the instruction after setb EA, see sched_run() */
+        if ((v & 0x80) && !(old & 0x80))
+            irq_hold = 2;
+        break;
+    default:
+        sim_sfr[reg] = v;
+        pins_update();
+        break;
+    }
+}
+
+void sim_write(uint8_t reg, uint8_t v)
+{
+    run_until(sim_now + sim_opt.cpu_ns);
+    sfr_store(reg, v);
+    take_irqs();
+}
+
+/* One instruction (orl, anl, xrl): no interrupt between the read and
+ * the write, and ports give their latch, not the pins */
+uint8_t sim_modify(uint8_t reg, uint8_t and_mask, uint8_t or_mask,
+                   uint8_t xor_mask)
+{
+    uint8_t v;
+
+    run_until(sim_now + sim_opt.cpu_ns);
+    v = ((sim_sfr[reg] & and_mask) | or_mask) ^ xor_mask;
+    sfr_store(reg, v);
+    take_irqs();
+    return v;
+}
+
+/* ---- reset ------------------------------------------------------------ */
+unsigned board_rx_overruns(void)
+{
+    return rx_overruns;
+}
+
+void board_reset(void)
+{
+    int p;
+
+    sim_sfr[SIM_P0]        = 0xFF;
+    sim_sfr[SIM_P1]        = 0xFF;
+    sim_sfr[SIM_P2]        = 0x1F;
+    sim_sfr[SIM_CLKCONCMD] = 0xC9;
+    sim_sfr[SIM_CHIPID]    = 0xA5;            /* CC2530 */
+    sim_sfr[SIM_SP]        = 0x07;
+
+    pin_ext[PIN_SDA]  = 1;                    /* pulled up */
+    pin_ext[PIN_BUSY] = 1;                    /* panel idle */
+    pin_ext[PIN_RX]   = 1;
+    for (p = 0; p < PIN_COUNT; p++)
+        pin_level[p] = pin_compute(p);
+}
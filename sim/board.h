@@ -0,0 +1,66 @@
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+/*
+ * Between the parts of the simulator (make sim); the firmware only
+ * sees sim.h through cc2530.h
+ */
+#include <stdint.h>
+#include <functional>
+
+typedef uint64_t sim_ns;
+
+#define SIM_US(x)  ((sim_ns)(x) * 1000)
+#define SIM_MS(x)  ((sim_ns)(x) * 1000000)
+
+/* Traced pins: P0_4, P0_2, P0_5, P0_3, P1_1, P1_2, P1_6, P1_7 */
+enum { PIN_CS, PIN_DC, PIN_SCK, PIN_SDA, PIN_RST, PIN_BUSY, PIN_TX, PIN_RX,
+       PIN_COUNT };
+
+/* Traced byte values */
+enum { BUS_SPI_CMD, BUS_SPI_DATA, BUS_UART_TX, BUS_UART_RX, BUS_COUNT };
+
+struct sim_options {
+    const char *vcd;             /* --vcd */
+    const char *link;            /* --link, symlink to the pty */
+    const char *frame;           /* --frame, PBM of every refresh */
+    int         temp_c;          /* --temp, on-chip sensor */
+    unsigned    cpu_ns;          /* --cpu-ns, per SFR access */
+    unsigned    refresh_ms;      /* --refresh-ms, 0x12 at 50 Hz */
+    unsigned    spi_max_khz;     /* --spi-max-khz, 0: no limit */
+    unsigned    idle_gap_ms;     /* --idle-gap, summary */
+    unsigned    tail_ms;         /* --tail-ms after the host left */
+    bool        once;            /* --once */
+    bool        verbose;         /* -v, decoded commands on stderr */
+};
+
+extern sim_options sim_opt;
+
+/* board.cpp: clock, events, pins */
+extern sim_ns sim_now;
+
+void    board_reset(void);
+void    board_at(sim_ns t, std::function<void()> fn);
+uint8_t board_pin(int pin);
+void    board_drive(int pin, uint8_t level);  /* panel: BUSY, SDA */
+void    board_host_byte(uint8_t b);           /* into the UART RX line */
+bool    board_rx_room(void);
+unsigned board_rx_overruns(void);
+
+/* panel.cpp: UC8151 */
+void panel_pin(int pin, uint8_t level);       /* CS, DC, SCK, RST changes */
+void panel_summary(void);
+const char *panel_cmd_name(uint8_t cmd);
+
+/* trace.cpp: VCD */
+void trace_open(const char *path);
+void trace_pin(int pin, uint8_t level);
+void trace_bus(int bus, int value);           /* -1: no value */
+void trace_close(void);
+
+/* main.cpp: the host on the pty */
+void host_tx(uint8_t b);
+void host_poll(int timeout_ms);
+void sim_finish(void);
+
+#endif /* SIM_BOARD_H */
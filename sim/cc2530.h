@@ -0,0 +1,60 @@
+#ifndef SIM_CC2530_H
+#define SIM_CC2530_H
+
+/*
+ * cc2530.h for the host build (make sim): SFRs and SFR bits as proxy
+ * objects that hand every access to the board model, see sim.h
+ */
+#include <stdint.h>
+#include "sim.h"
+
+struct sim_reg {
+    uint8_t r;
+
+    operator uint8_t() const          { return sim_read(r); }
+    uint8_t operator=(int v) const    { sim_write(r, (uint8_t)v); return (uint8_t)v; }
+    uint8_t operator|=(int v) const   { return sim_modify(r, 0xFF, v, 0); }
+    uint8_t operator&=(int v) const   { return sim_modify(r, v, 0, 0); }
+    uint8_t operator^=(int v) const   { return sim_modify(r, 0xFF, 0, v); }
+};
+
+/* A bit write leaves the other bits as they are, without a read cycle */
+struct sim_bit {
+    uint8_t r, b;
+
+    operator uint8_t() const          { return (sim_read(r) >> b) & 1; }
+    uint8_t operator=(int v) const
+    {
+        sim_write(r, v ? sim_sfr[r] | (1 << b) : sim_sfr[r] & ~(1 << b));
+        return v != 0;
+    }
+};
+
+#define SIM_REG_DEF(n)        static const sim_reg n = { SIM_##n };
+#define SIM_BIT_DEF(n, r, b)  static const sim_bit n = { SIM_##r, b };
+SIM_REGS(SIM_REG_DEF)
+SIM_BITS(SIM_BIT_DEF)
+#undef SIM_REG_DEF
+#undef SIM_BIT_DEF
+
+/* Interrupt vectors, only used in __interrupt(), see sdcc.h */
+#define RFERR_VECTOR   0
+#define ADC_VECTOR     1
+#define URX0_VECTOR    2
+#define URX1_VECTOR    3
+#define ENC_VECTOR     4
+#define ST_VECTOR      5
+#define P2INT_VECTOR   6
+#define UTX0_VECTOR    7
+#define DMA_VECTOR     8
+#define T1_VECTOR      9
+#define T2_VECTOR      10
+#define T3_VECTOR      11
+#define T4_VECTOR      12
+#define P0INT_VECTOR   13
+#define UTX1_VECTOR    14
+#define P1INT_VECTOR   15
+#define RF_VECTOR      16
+#define WDT_VECTOR     17
+
+#endif /* SIM_CC2530_H */
@@ -0,0 +1,205 @@
+/*
+ * main.cpp — eink_sim: the firmware on the host, its UART on a pty
+ *
+ *   eink_sim --link /tmp/eink --vcd trace.vcd
+ *   EINK_PORT=/tmp/eink python3 host_script/send.py show image.bin
+ *
+ * The host tools open the pty like the tag's serial port. Ctrl-C (or,
+ * with --once, the host closing the port and --tail-ms more) ends the
+ * run: the VCD is closed and the UC8151 summary printed.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include "board.h"
+
+void firmware_main(void);
+
+sim_options sim_opt = {
+    NULL, NULL, NULL,
+    22,        /* temp_c */
+    250,       /* cpu_ns */
+    3000,      /* refresh_ms */
+    0,         /* spi_max_khz */
+    1000,      /* idle_gap_ms */
+    6000,      /* tail_ms: the panel's idle power off */
+    false, false,
+};
+
+static int pty = -1;
+static bool host_seen, host_left;
+static unsigned host_leaves;
+static volatile sig_atomic_t stop;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop = 1;
+}
+
+void sim_finish(void)
+{
+    trace_close();
+    panel_summary();
+    if (sim_opt.link)
+        unlink(sim_opt.link);
+    exit(0);
+}
+
+/* Dropped while no host has the port open, like a UART with nobody
+ * listening */
+void host_tx(uint8_t b)
+{
+    if (write(pty, &b, 1) < 0 && errno != EAGAIN && errno != EIO)
+        perror("pty");
+}
+
+/* Host bytes onto the RX line; waits up to timeout_ms of real time */
+void host_poll(int timeout_ms)
+{
+    struct pollfd p = { pty, POLLIN, 0 };
+    uint8_t buf[64];
+    ssize_t n, i;
+
+    if (stop)
+        sim_finish();
+    if (!board_rx_room())
+        return;
+
+    if (poll(&p, 1, timeout_ms) <= 0)
+        return;
+    if (!(p.revents & POLLIN)) {
+        /* POLLHUP: no host has the port open */
+        if (host_seen && !host_left) {
+            unsigned leave = ++host_leaves;
+
+            host_left = true;
+            if (sim_opt.once)                 /* unless it came back */
+                board_at(sim_now + SIM_MS(sim_opt.tail_ms), [leave] {
+                    if (host_left && leave == host_leaves)
+                        sim_finish();
+                });
+        }
+        if (timeout_ms)
+            usleep(timeout_ms * 1000);
+        return;
+    }
+
+    n = read(pty, buf, sizeof buf);
+    if (n <= 0)
+        return;
+    host_seen = true;
+    host_left = false;
+    for (i = 0; i < n; i++)
+        board_host_byte(buf[i]);
+}
+
+static void pty_open(void)
+{
+    struct termios t;
+    const char *name;
+    int slave;
+
+    pty = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (pty < 0 || grantpt(pty) || unlockpt(pty) || !(name = ptsname(pty))) {
+        perror("pty");
+        exit(1);
+    }
+
+    /* Raw, the setting stays with the pty when we let go of it */
+    slave = open(name, O_RDWR | O_NOCTTY);
+    if (slave >= 0) {
+        tcgetattr(slave, &t);
+        cfmakeraw(&t);
+        tcsetattr(slave, TCSANOW, &t);
+        close(slave);
+    }
+
+    if (sim_opt.link) {
+        unlink(sim_opt.link);
+        if (symlink(name, sim_opt.link)) {
+            perror(sim_opt.link);
+            exit(1);
+        }
+        name = sim_opt.link;
+    }
+    fprintf(stderr, "eink_sim: tag UART on %s\n", name);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: eink_sim [options]\n"
+        "  --link PATH        symlink to the pty (default: print its name)\n"
+        "  --vcd FILE         pin-level trace, FILE.filter names the commands\n"
+        "  --frame FILE       PBM of the panel RAM at every refresh\n"
+        "  --temp C           on-chip temperature sensor (%d)\n"
+        "  --cpu-ns N         CPU time per SFR access (%u)\n"
+        "  --refresh-ms N     0x12 refresh at 50 Hz (%u)\n"
+        "  --spi-max-khz N    panel misreads faster SPI clocks (no limit)\n"
+        "  --idle-gap MS      summary: longer gaps are idle (%u)\n"
+        "  --once             end --tail-ms after the host closes the port\n"
+        "  --tail-ms N        (%u)\n"
+        "  -v                 print the UC8151 commands as they go\n",
+        sim_opt.temp_c, sim_opt.cpu_ns, sim_opt.refresh_ms,
+        sim_opt.idle_gap_ms, sim_opt.tail_ms);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *a, *v;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        a = argv[i];
+        if (!strcmp(a, "-v")) {
+            sim_opt.verbose = true;
+            continue;
+        }
+        if (!strcmp(a, "--once")) {
+            sim_opt.once = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            usage();
+        v = argv[++i];
+        if (!strcmp(a, "--link"))
+            sim_opt.link = v;
+        else if (!strcmp(a, "--vcd"))
+            sim_opt.vcd = v;
+        else if (!strcmp(a, "--frame"))
+            sim_opt.frame = v;
+        else if (!strcmp(a, "--temp"))
+            sim_opt.temp_c = atoi(v);
+        else if (!strcmp(a, "--cpu-ns"))
+            sim_opt.cpu_ns = atoi(v);
+        else if (!strcmp(a, "--refresh-ms"))
+            sim_opt.refresh_ms = atoi(v);
+        else if (!strcmp(a, "--spi-max-khz"))
+            sim_opt.spi_max_khz = atoi(v);
+        else if (!strcmp(a, "--idle-gap"))
+            sim_opt.idle_gap_ms = atoi(v);
+        else if (!strcmp(a, "--tail-ms"))
+            sim_opt.tail_ms = atoi(v);
+        else
+            usage();
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    pty_open();
+
+    board_reset();
+    if (sim_opt.vcd)
+        trace_open(sim_opt.vcd);
+
+    firmware_main();                  /* sched_run() does not return */
+    return 0;
+}
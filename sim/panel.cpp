@@ -0,0 +1,416 @@
+/*
+ * panel.cpp — the UC8151 behind the SPI pins, as far as the driver
+ * (GxGDEW0213Z16.c) uses it
+ *
+ * A byte is shifted in on the rising SCK edges while CS is low; DC
+ * tells a command from its data. BUSY_N goes low for power on (0x04),
+ * power off (0x02) and the refresh (0x12), whose length is --refresh-ms
+ * at the default 50 Hz frame rate and shrinks with a faster one (0x30).
+ * After 0x70 (revision) and 0x71 (status), with DC high, the panel
+ * drives SDA itself, one bit per rising edge (3-wire read). Bytes
+ * clocked faster than --spi-max-khz come in with bit 0 flipped, which
+ * is what the SPI calibration has to find out.
+ *
+ * Every command opens a segment that runs until the next command or
+ * reset; panel_summary() totals them per command.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "board.h"
+
+#define PANEL_W        104
+#define PANEL_H        212
+#define PANEL_FRAME    (PANEL_W / 8 * PANEL_H)
+#define PANEL_PON_MS   80
+#define PANEL_POF_MS   20
+#define PANEL_RST      256            /* RST low, as a pseudo command */
+#define SEG_LOG_BYTES  8
+
+/* Reads as a fixed, made-up revision */
+static const uint8_t panel_rev[] = { 0x0C, 0x01, 0x15, 0x1A };
+
+const char *panel_cmd_name(uint8_t cmd)
+{
+    switch (cmd) {
+    case 0x00: return "PSR";
+    case 0x01: return "PWR";
+    case 0x02: return "POF";
+    case 0x03: return "PFS";
+    case 0x04: return "PON";
+    case 0x05: return "PMES";
+    case 0x06: return "BTST";
+    case 0x07: return "DSLP";
+    case 0x10: return "DTM1";
+    case 0x11: return "DSP";
+    case 0x12: return "DRF";
+    case 0x13: return "DTM2";
+    case 0x20: return "LUTC";
+    case 0x21: return "LUTWW";
+    case 0x22: return "LUTBW";
+    case 0x23: return "LUTWB";
+    case 0x24: return "LUTBB";
+    case 0x30: return "PLL";
+    case 0x40: return "TSC";
+    case 0x41: return "TSE";
+    case 0x42: return "TSW";
+    case 0x43: return "TSR";
+    case 0x50: return "CDI";
+    case 0x51: return "LPD";
+    case 0x60: return "TCON";
+    case 0x61: return "TRES";
+    case 0x65: return "GSST";
+    case 0x70: return "REV";
+    case 0x71: return "FLG";
+    case 0x80: return "AMV";
+    case 0x81: return "VV";
+    case 0x82: return "VDCS";
+    case 0x90: return "PTL";
+    case 0x91: return "PTIN";
+    case 0x92: return "PTOUT";
+    case 0xA0: return "PGM";
+    case 0xA1: return "APG";
+    case 0xA2: return "ROTP";
+    case 0xE0: return "CCSET";
+    case 0xE3: return "PWS";
+    case 0xE5: return "TSSET";
+    }
+    return "?";
+}
+
+/* ---- state ------------------------------------------------------------ */
+static int      cmd = -1;             /* current command, -1 after reset */
+static uint32_t data_n;               /* data bytes since it */
+static uint8_t  shift, nbits, rd;
+static sim_ns   byte_start, last_rise, min_period;
+
+static bool     powered, sleeping;
+static uint8_t  pll = 0x3C;
+static unsigned busy_gen;
+static sim_ns   busy_end;
+
+static uint8_t  frame[PANEL_FRAME];   /* DTM2 */
+
+static bool is_read(int c)
+{
+    return c == 0x70 || c == 0x71;
+}
+
+static unsigned frame_hz(void)
+{
+    switch (pll) {
+    case 0x39: return 200;
+    case 0x29: return 150;
+    case 0x3A: return 100;
+    }
+    return 50;                        /* 0x3C, and anything unknown */
+}
+
+/* ---- summary ---------------------------------------------------------- */
+struct cmd_stats {
+    unsigned count;
+    uint64_t bytes;
+    sim_ns   bus, busy, after;
+};
+
+struct segment {
+    int      cmd;                     /* -1: none open */
+    sim_ns   start, end;              /* first clock to last byte */
+    sim_ns   busy;                    /* BUSY it started */
+    uint32_t n;
+    uint8_t  first[SEG_LOG_BYTES];
+};
+
+static cmd_stats        stats[PANEL_RST + 1];
+static std::vector<int> stats_order;
+static segment          seg = { -1, 0, 0, 0, 0, {} };
+static sim_ns           idle_total;
+static sim_ns           dtm2_start;
+static unsigned         updates;
+static sim_ns           update_total;
+
+static const char *seg_name(int c)
+{
+    return c == PANEL_RST ? "RST" : panel_cmd_name((uint8_t)c);
+}
+
+/* Close the open segment at t: its bus time, and the gap after it or
+ * after the BUSY it started, unless the gap is long enough to be idle */
+static void segment_close(sim_ns t)
+{
+    cmd_stats *s;
+    sim_ns done, gap = 0;
+    uint32_t i;
+
+    if (seg.cmd < 0)
+        return;
+    s = &stats[seg.cmd];
+    s->bus += seg.end - seg.start;
+    done = seg.end > busy_end ? seg.end : busy_end;
+    if (t > done) {
+        gap = t - done;
+        if (gap >= SIM_MS(sim_opt.idle_gap_ms))
+            idle_total += gap;
+        else
+            s->after += gap;
+    }
+
+    if (sim_opt.verbose) {
+        fprintf(stderr, "%12.3f ms  ", seg.start / 1e6);
+        if (seg.cmd == PANEL_RST)
+            fprintf(stderr, "RST low %.3f ms", (seg.end - seg.start) / 1e6);
+        else
+            fprintf(stderr, "0x%02X %-5s", seg.cmd, seg_name(seg.cmd));
+        for (i = 0; i < seg.n && i < SEG_LOG_BYTES; i++)
+            fprintf(stderr, " %02X", seg.first[i]);
+        if (seg.n > SEG_LOG_BYTES)
+            fprintf(stderr, " ... (%u bytes)", seg.n);
+        if (seg.busy)
+            fprintf(stderr, "  busy %.3f ms", seg.busy / 1e6);
+        fputc('\n', stderr);
+    }
+    seg.cmd = -1;
+}
+
+static void segment_open(int c, sim_ns start)
+{
+    segment_close(start);
+    if (!stats[c].count)
+        stats_order.push_back(c);
+    stats[c].count++;
+    seg.cmd   = c;
+    seg.start = start;
+    seg.end   = sim_now;
+    seg.busy  = 0;
+    seg.n     = 0;
+}
+
+void panel_summary(void)
+{
+    cmd_stats total = {};
+    cmd_stats *s;
+    int c;
+
+    segment_close(sim_now);
+
+    fprintf(stderr, "\nUC8151, %.3f ms simulated\n", sim_now / 1e6);
+    fprintf(stderr, "cmd   name   count    bytes     bus ms    busy ms   after ms\n");
+    for (int i : stats_order) {
+        s = &stats[i];
+        c = i;
+        if (c == PANEL_RST)
+            fprintf(stderr, "--    ");
+        else
+            fprintf(stderr, "0x%02X  ", c);
+        fprintf(stderr, "%-5s %6u %8llu %10.3f %10.3f %10.3f\n", seg_name(c),
+                s->count, (unsigned long long)s->bytes,
+                s->bus / 1e6, s->busy / 1e6, s->after / 1e6);
+        total.count += s->count;
+        total.bytes += s->bytes;
+        total.bus   += s->bus;
+        total.busy  += s->busy;
+        total.after += s->after;
+    }
+    fprintf(stderr, "total       %6u %8llu %10.3f %10.3f %10.3f\n",
+            total.count, (unsigned long long)total.bytes,
+            total.bus / 1e6, total.busy / 1e6, total.after / 1e6);
+    fprintf(stderr, "idle (gaps of %u ms and more): %.3f ms\n",
+            sim_opt.idle_gap_ms, idle_total / 1e6);
+    if (updates)
+        fprintf(stderr, "refreshes: %u, DTM2 to BUSY released %.3f ms on average\n",
+                updates, update_total / 1e6 / updates);
+    if (board_rx_overruns())
+        fprintf(stderr, "UART RX overruns: %u\n", board_rx_overruns());
+}
+
+/* ---- BUSY ------------------------------------------------------------- */
+static void frame_write(void)
+{
+    FILE *f = fopen(sim_opt.frame, "wb");
+
+    if (!f) {
+        perror(sim_opt.frame);
+        return;
+    }
+    /* DTM2 bits are 1 for ink, PBM's for black */
+    fprintf(f, "P4\n%d %d\n", PANEL_W, PANEL_H);
+    fwrite(frame, 1, sizeof frame, f);
+    fclose(f);
+}
+
+static void busy_start(sim_ns d, bool refresh)
+{
+    unsigned gen = ++busy_gen;
+
+    stats[seg.cmd].busy += d;
+    seg.busy = d;
+    busy_end = sim_now + d;
+    board_drive(PIN_BUSY, 0);
+    board_at(busy_end, [gen, refresh] {
+        if (gen != busy_gen)
+            return;
+        if (refresh && dtm2_start) {
+            updates++;
+            update_total += sim_now - dtm2_start;
+            dtm2_start = 0;
+        }
+        board_drive(PIN_BUSY, 1);
+    });
+}
+
+static void busy_cancel(void)
+{
+    if (busy_end > sim_now) {
+        if (seg.cmd >= 0 && seg.busy) {
+            stats[seg.cmd].busy -= busy_end - sim_now;
+            seg.busy -= busy_end - sim_now;
+        }
+        busy_end = sim_now;
+    }
+    busy_gen++;
+    board_drive(PIN_BUSY, 1);
+}
+
+/* ---- bytes ------------------------------------------------------------ */
+static void panel_command(uint8_t c)
+{
+    segment_open(c, byte_start);
+    cmd    = c;
+    data_n = 0;
+
+    switch (c) {
+    case 0x04:
+        if (!powered) {
+            powered = true;
+            busy_start(SIM_MS(PANEL_PON_MS), false);
+        }
+        break;
+    case 0x02:
+        if (powered) {
+            powered = false;
+            busy_start(SIM_MS(PANEL_POF_MS), false);
+        }
+        break;
+    case 0x12:
+        if (powered) {
+            if (sim_opt.frame)
+                frame_write();
+            busy_start(SIM_MS(sim_opt.refresh_ms) * 50 / frame_hz(), true);
+        }
+        break;
+    case 0x13:
+        dtm2_start = byte_start;
+        break;
+    }
+}
+
+static void panel_data(uint8_t b)
+{
+    if (cmd < 0)
+        return;
+    if (seg.n < SEG_LOG_BYTES)
+        seg.first[seg.n] = b;
+    seg.n++;
+    seg.end = sim_now;
+    stats[cmd].bytes++;
+
+    switch (cmd) {
+    case 0x07:
+        if (b == 0xA5)
+            sleeping = true;
+        break;
+    case 0x30:
+        pll = b;
+        break;
+    case 0x13:
+        if (data_n < PANEL_FRAME)
+            frame[data_n] = b;
+        break;
+    }
+    data_n++;
+}
+
+/* BUSY_N, POF, PON */
+static uint8_t read_byte(void)
+{
+    if (cmd == 0x71)
+        return board_pin(PIN_BUSY) | (!powered << 1) | (powered << 2);
+    return data_n < sizeof panel_rev ? panel_rev[data_n] : 0xFF;
+}
+
+static void sck_rise(void)
+{
+    uint8_t b;
+
+    if (!nbits) {
+        byte_start = sim_now;
+        min_period = ~(sim_ns)0;
+    } else if (sim_now - last_rise < min_period) {
+        min_period = sim_now - last_rise;
+    }
+    last_rise = sim_now;
+
+    if (board_pin(PIN_DC) && is_read(cmd)) {
+        if (!nbits)
+            rd = read_byte();
+        b = rd;
+        if (sim_opt.spi_max_khz && min_period < 1000000 / sim_opt.spi_max_khz)
+            b ^= 0x01;
+        board_drive(PIN_SDA, (b >> (7 - nbits)) & 1);
+        if (++nbits == 8) {
+            nbits = 0;
+            trace_bus(BUS_SPI_DATA, rd);
+            panel_data(rd);
+        }
+        return;
+    }
+
+    shift = (shift << 1) | board_pin(PIN_SDA);
+    if (++nbits < 8)
+        return;
+    nbits = 0;
+
+    b = shift;
+    if (sim_opt.spi_max_khz && min_period < 1000000 / sim_opt.spi_max_khz)
+        b ^= 0x01;
+    if (board_pin(PIN_DC)) {
+        trace_bus(BUS_SPI_DATA, b);
+        panel_data(b);
+    } else {
+        trace_bus(BUS_SPI_CMD, b);
+        panel_command(b);
+    }
+}
+
+void panel_pin(int pin, uint8_t level)
+{
+    switch (pin) {
+    case PIN_RST:
+        if (!level) {
+            segment_open(PANEL_RST, sim_now);
+            busy_cancel();
+            cmd      = -1;
+            powered  = false;
+            sleeping = false;
+            pll      = 0x3C;
+            nbits    = 0;
+        } else if (seg.cmd == PANEL_RST) {
+            seg.end = sim_now;
+        }
+        break;
+
+    case PIN_CS:
+        if (level) {                  /* a byte cut short is lost */
+            nbits = 0;
+            trace_bus(BUS_SPI_CMD, -1);
+            trace_bus(BUS_SPI_DATA, -1);
+            board_drive(PIN_SDA, 1);
+        }
+        break;
+
+    case PIN_SCK:
+        if (level && !board_pin(PIN_CS) && board_pin(PIN_RST) && !sleeping)
+            sck_rise();
+        break;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef SIM_SDCC_H
+#define SIM_SDCC_H
+
+/*
+ * SDCC extensions as no-ops for the host build (make sim), included
+ * ahead of every firmware file. Memory spaces are all one on the host;
+ * interrupt handlers are plain functions called by the board model.
+ */
+#define __xdata
+#define __code
+#define __data
+#define __idata
+#define __pdata
+#define __naked
+#define __reentrant
+#define __banked
+#define __nonbanked
+#define __critical
+#define __interrupt(n)
+#define __using(n)
+#define __at(a)
+
+#define SIM 1
+
+/* main() is the firmware's, the simulator has its own */
+#define main firmware_main
+
+#endif /* SIM_SDCC_H */
@@ -0,0 +1,63 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+/*
+ * Host simulation of the tag (make sim)
+ *
+ * The firmware is compiled for the host with g++ against sim/cc2530.h,
+ * where every SFR is a proxy object: reads and writes land in
+ * sim_read()/sim_write() of the board model (board.cpp), which keeps
+ * a discrete-event clock in nanoseconds. Time only passes where the
+ * hardware takes it: SPI and UART shifts, the ADC, the panel's BUSY
+ * periods, the CPU's idle (PCON) and a fixed cost per SFR access
+ * standing in for the instructions in between. Interrupts are taken
+ * after the SFR access that made them due, so they preempt the
+ * firmware where the hardware would, give or take an access.
+ *
+ * Every registered pin change is written to a VCD (trace.cpp) together
+ * with the decoded SPI and UART bytes; panel.cpp models the UC8151
+ * behind the SPI pins.
+ */
+
+/* Registers the firmware touches; X(name) */
+#define SIM_REGS(X) \
+    X(P0) X(P1) X(P2) X(P0SEL) X(P1SEL) X(P2SEL) X(P0DIR) X(P1DIR) X(P2DIR) \
+    X(PERCFG) X(PICTL) X(P1IEN) X(P1IFG) \
+    X(U0CSR) X(U0DBUF) X(U0BAUD) X(U0UCR) X(U0GCR) \
+    X(U1CSR) X(U1DBUF) X(U1BAUD) X(U1UCR) X(U1GCR) \
+    X(IEN0) X(IEN1) X(IEN2) X(TCON) X(IRCON) X(IRCON2) \
+    X(ST0) X(ST1) X(ST2) X(STLOAD) X(PCON) X(SLEEPCMD) \
+    X(CLKCONCMD) X(CLKCONSTA) X(WDCTL) X(CHIPID) X(SP) X(DPS) X(MEMCTR) X(FMAP) \
+    X(ADCCON1) X(ADCCON3) X(ADCL) X(ADCH) X(TR0) X(ATEST) \
+    X(DMAARM) X(DMAREQ) X(DMAIRQ) \
+    X(DMA0CFGH) X(DMA0CFGL) X(DMA1CFGH) X(DMA1CFGL) \
+    X(T1CTL) X(T1CNTL) X(T1CNTH)
+
+/* Bit-addressable flags; X(name, register, bit) */
+#define SIM_BITS(X) \
+    X(P0_0, P0, 0) X(P0_1, P0, 1) X(P0_2, P0, 2) X(P0_3, P0, 3) \
+    X(P0_4, P0, 4) X(P0_5, P0, 5) X(P0_6, P0, 6) X(P0_7, P0, 7) \
+    X(P1_0, P1, 0) X(P1_1, P1, 1) X(P1_2, P1, 2) X(P1_3, P1, 3) \
+    X(P1_4, P1, 4) X(P1_5, P1, 5) X(P1_6, P1, 6) X(P1_7, P1, 7) \
+    X(EA, IEN0, 7) X(STIE, IEN0, 5) X(URX1IE, IEN0, 3) X(URX0IE, IEN0, 2) \
+    X(DMAIE, IEN1, 0) \
+    X(URX1IF, TCON, 7) X(STIF, IRCON, 7) X(DMAIF, IRCON, 0) X(P1IF, IRCON2, 3)
+
+enum {
+#define SIM_REG_ENUM(n) SIM_##n,
+    SIM_REGS(SIM_REG_ENUM)
+#undef SIM_REG_ENUM
+    SIM_REG_COUNT
+};
+
+/* Raw register contents, without side effects */
+extern uint8_t sim_sfr[SIM_REG_COUNT];
+
+uint8_t sim_read(uint8_t reg);
+void    sim_write(uint8_t reg, uint8_t value);
+uint8_t sim_modify(uint8_t reg, uint8_t and_mask, uint8_t or_mask,
+                   uint8_t xor_mask);
+
+#endif /* SIM_H */
@@ -0,0 +1,126 @@
+/*
+ * trace.cpp — pin-level VCD of the simulated tag
+ *
+ * One wire per pin in board.h and an 8-bit vector per decoded byte
+ * stream: a byte shows on spi_cmd/spi_data from its 8th clock until CS
+ * goes high (or the next byte), on uart_tx/uart_rx for its frame, and
+ * is z otherwise. Next to the VCD goes <vcd>.filter, a GTKWave
+ * translate filter file naming the UC8151 commands on spi_cmd.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "board.h"
+
+static const char *pin_names[PIN_COUNT] = {
+    "cs", "dc", "sck", "sda", "rst", "busy_n", "uart_tx", "uart_rx",
+};
+
+static const char *bus_names[BUS_COUNT] = {
+    "spi_cmd", "spi_data", "uart_tx_byte", "uart_rx_byte",
+};
+
+static FILE  *vcd;
+static sim_ns vcd_time;
+static int    bus_value[BUS_COUNT];
+
+/* Identifier codes: pins first, then the buses */
+static char pin_id(int pin) { return '!' + pin; }
+static char bus_id(int bus) { return '!' + PIN_COUNT + bus; }
+
+static void vcd_at(void)
+{
+    if (sim_now != vcd_time) {
+        vcd_time = sim_now;
+        fprintf(vcd, "#%llu\n", (unsigned long long)vcd_time);
+    }
+}
+
+static void vcd_bus(int bus, int value)
+{
+    int i;
+
+    fputc('b', vcd);
+    if (value < 0)
+        fputc('z', vcd);
+    else
+        for (i = 7; i >= 0; i--)
+            fputc('0' + ((value >> i) & 1), vcd);
+    fprintf(vcd, " %c\n", bus_id(bus));
+}
+
+static void filter_write(const char *path)
+{
+    std::string name = std::string(path) + ".filter";
+    FILE *f = fopen(name.c_str(), "w");
+    const char *s;
+    int c;
+
+    if (!f) {
+        perror(name.c_str());
+        return;
+    }
+    for (c = 0; c < 256; c++) {
+        s = panel_cmd_name((uint8_t)c);
+        if (strcmp(s, "?"))
+            fprintf(f, "%02X %s\n", c, s);
+    }
+    fclose(f);
+}
+
+void trace_open(const char *path)
+{
+    int i;
+
+    vcd = fopen(path, "w");
+    if (!vcd) {
+        perror(path);
+        return;
+    }
+
+    fprintf(vcd, "$version eink_sim $end\n$timescale 1ns $end\n"
+                 "$scope module tag $end\n");
+    for (i = 0; i < PIN_COUNT; i++)
+        fprintf(vcd, "$var wire 1 %c %s $end\n", pin_id(i), pin_names[i]);
+    for (i = 0; i < BUS_COUNT; i++)
+        fprintf(vcd, "$var wire 8 %c %s [7:0] $end\n", bus_id(i), bus_names[i]);
+    fprintf(vcd, "$upscope $end\n$enddefinitions $end\n");
+
+    fprintf(vcd, "#%llu\n$dumpvars\n", (unsigned long long)sim_now);
+    vcd_time = sim_now;
+    for (i = 0; i < PIN_COUNT; i++)
+        fprintf(vcd, "%d%c\n", board_pin(i), pin_id(i));
+    for (i = 0; i < BUS_COUNT; i++) {
+        bus_value[i] = -1;
+        vcd_bus(i, -1);
+    }
+    fprintf(vcd, "$end\n");
+
+    filter_write(path);
+}
+
+void trace_pin(int pin, uint8_t level)
+{
+    if (!vcd)
+        return;
+    vcd_at();
+    fprintf(vcd, "%d%c\n", level, pin_id(pin));
+}
+
+void trace_bus(int bus, int value)
+{
+    if (!vcd || value == bus_value[bus])
+        return;
+    bus_value[bus] = value;
+    vcd_at();
+    vcd_bus(bus, value);
+}
+
+void trace_close(void)
+{
+    if (!vcd)
+        return;
+    vcd_at();
+    fclose(vcd);
+    vcd = NULL;
+}
@@ -7,6 +7,10 @@
  *   P0_4 → EINK_CS    (manual GPIO — P0_4 is MISO on Alt.2 but
  *                       e-ink is write-only so we use it as CS GPIO)
  *
+ * Reads: the panel answers on its SDA line, i.e. on MOSI (3-wire). The
+ * USART can't receive there, so SPI_ReadRegister() bit-bangs the read
+ * with P0_3/P0_5 switched back to GPIO.
+ *
  * STM32 equivalent config translated:
  *   Mode     = SPI_MODE_MASTER       → U0CSR bit5=0 (master)
  *   CPOL     = SPI_POLARITY_LOW      → U0GCR CPOL=0
@@ -18,22 +22,41 @@
  *
  * Baud rate:
  *   F = (256 + BAUD_M) * 2^BAUD_E / 2^28 * 32MHz
- *   BAUD_E=13, BAUD_M=0 → ~1MHz  (close to STM32 @64MHz/64 = 1MHz)
- *   BAUD_E=12, BAUD_M=0 → ~500kHz (conservative, safe for first bringup)
+ *   BAUD_E=15, BAUD_M=0   → 1MHz
+ *   BAUD_E=16, BAUD_M=0   → 2MHz (SPI_RATE_DEFAULT)
+ *   BAUD_E=16, BAUD_M=128 → 3MHz
+ *   BAUD_E=17, BAUD_M=0   → 4MHz, F/8, the maximum in master mode
  */
 
 #include "spi.h"
 #include <cc2530.h>
 
+#define U0GCR_MODE  ((0<<7) | (0<<6) | (1<<5))   /* CPOL=0, CPHA=0, MSB first */
+
+typedef struct {
+    uint8_t  baud_e;
+    uint8_t  baud_m;
+    uint16_t khz;
+} spi_rate_t;
+
+static __code const spi_rate_t spi_rates[SPI_RATES] = {
+    { 15,   0, 1000 },
+    { 16,   0, 2000 },
+    { 16, 128, 3000 },
+    { 17,   0, 4000 },
+};
+
+static uint8_t spi_rate;
+
 /* -----------------------------------------------------------------------
  * CS pin — P0_4 as plain GPIO
  * ----------------------------------------------------------------------- */
-void SPI_CS_LOW(void)  { P0_4 = 0; }
-void SPI_CS_HIGH(void) { P0_4 = 1; }
+void SPI_CS_LOW(void) NONBANKED  { P0_4 = 0; }
+void SPI_CS_HIGH(void) NONBANKED { P0_4 = 1; }
 
 // dc pin
-void SPI_DC_LOW(void)  { P0_2 = 0; }
-void SPI_DC_HIGH(void) { P0_2 = 1; }
+void SPI_DC_LOW(void) NONBANKED  { P0_2 = 0; }
+void SPI_DC_HIGH(void) NONBANKED { P0_2 = 1; }
 
 // rst pin
 void SPI_RST_LOW(void)  { P1_1 = 0; }
@@ -91,20 +114,34 @@ void SPI_Init(void)
      *
      * CPOL=0, CPHA=0 → SPI Mode 0 (matches STM32 POLARITY_LOW + PHASE_1EDGE)
      * ORDER=1 → MSB first
-     * BAUD_E=12 → ~500kHz safe for bringup, change to 13 for ~1MHz
+     * BAUD_E from spi_rates[], see SPI_SetRate()
      */
-    U0GCR = (0<<7) |   /* CPOL=0  */
-            (0<<6) |   /* CPHA=0  */
-            (1<<5) |   /* MSB first */
-            16;        // baud_e = 16, try 2mhz spi clock
-
-    /* BAUD_M=0 (mantissa), combined with BAUD_E gives final rate */
-    U0BAUD = 0;
+    SPI_SetRate(SPI_RATE_DEFAULT);
 
     /* Flush any garbage in the buffer */
     U0UCR |= 0x80;
 }
 
+/* -----------------------------------------------------------------------
+ * Clock: BAUD_E in U0GCR, BAUD_M (mantissa) in U0BAUD
+ * ----------------------------------------------------------------------- */
+void SPI_SetRate(uint8_t rate)
+{
+    spi_rate = rate;
+    U0GCR    = U0GCR_MODE | spi_rates[rate].baud_e;
+    U0BAUD   = spi_rates[rate].baud_m;
+}
+
+uint8_t SPI_Rate(void)
+{
+    return spi_rate;
+}
+
+uint16_t SPI_RateKHz(uint8_t rate)
+{
+    return spi_rates[rate].khz;
+}
+
 /* -----------------------------------------------------------------------
  * Write one byte — blocks until TX complete
  *
@@ -120,7 +157,7 @@ void SPI_Init(void)
 //     while (!(U0CSR & 0x02)); /* wait until TX_BYTE set (byte shifted out) */
 // }
 
-void DEV_SPI_WriteByte(uint8_t value)
+void DEV_SPI_WriteByte(uint8_t value) NONBANKED
 {
     U0CSR &= ~0x02;          // clear TX flag
     U0DBUF = value;          // start transfer
@@ -129,4 +166,61 @@ void DEV_SPI_WriteByte(uint8_t value)
     //while (!(U0CSR & 0x01)); // wait RX done
 
     (void)U0DBUF;            // dummy read to clear RX
-}
\ No newline at end of file
+}
+
+/* -----------------------------------------------------------------------
+ * Write n bytes back to back, each XORed with x (0xFF sends them
+ * inverted). CS and DC are the caller's, so a command's data or a run
+ * of frame rows goes out as one burst. The next byte is fetched while
+ * the current one shifts out, and RX is left alone.
+ * ----------------------------------------------------------------------- */
+void SPI_WriteBytes(const uint8_t *buf, uint8_t n, uint8_t x) NONBANKED
+{
+    uint8_t b;
+
+    if (!n)
+        return;
+    b = *buf++ ^ x;
+    while (n) {
+        U0CSR &= ~0x02;
+        U0DBUF = b;
+        if (--n)
+            b = *buf++ ^ x;
+        while (!(U0CSR & 0x02));
+    }
+}
+
+/* -----------------------------------------------------------------------
+ * Read n bytes of register reg, 3-wire
+ *
+ * The command goes out through the USART at the current rate; then, DC
+ * high, the panel shifts the reply out on SDA, sampled here on the
+ * rising edge of a GPIO clock (~1 MHz, independent of the rate).
+ * ----------------------------------------------------------------------- */
+void SPI_ReadRegister(uint8_t reg, __xdata uint8_t *buf, uint8_t n)
+{
+    uint8_t b, i;
+
+    SPI_DC_LOW();
+    SPI_CS_LOW();
+    DEV_SPI_WriteByte(reg);
+    SPI_DC_HIGH();
+
+    P0_5   = 0;                          /* CPOL=0 once on GPIO */
+    P0SEL &= ~((1<<3) | (1<<5));
+    P0DIR &= ~(1<<3);                    /* SDA is the panel's now */
+
+    while (n--) {
+        b = 0;
+        for (i = 0; i < 8; i++) {
+            P0_5 = 1;
+            b    = (b << 1) | P0_3;
+            P0_5 = 0;
+        }
+        *buf++ = b;
+    }
+
+    P0DIR |= (1<<3);
+    P0SEL |= (1<<3) | (1<<5);
+    SPI_CS_HIGH();
+}
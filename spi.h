@@ -2,13 +2,27 @@
 #define SPI_H
 
 #include <stdint.h>
+#include "bank.h"
+
+/*
+ * SPI clocks to choose from, slowest first. The USART's F/8 limit in
+ * master mode is 4 MHz. SPI_Init() starts at SPI_RATE_DEFAULT until the
+ * panel sequencer has calibrated the link (GxGDEW0213Z16.c).
+ */
+#define SPI_RATES         4
+#define SPI_RATE_DEFAULT  1    /* 2 MHz */
 
 void SPI_Init(void);
-void DEV_SPI_WriteByte(uint8_t value);
-void SPI_CS_LOW(void);
-void SPI_CS_HIGH(void);
-void SPI_DC_LOW(void);
-void SPI_DC_HIGH(void);
+void SPI_SetRate(uint8_t rate);
+uint8_t SPI_Rate(void);
+uint16_t SPI_RateKHz(uint8_t rate);
+void DEV_SPI_WriteByte(uint8_t value) NONBANKED;
+void SPI_WriteBytes(const uint8_t *buf, uint8_t n, uint8_t x) NONBANKED;
+void SPI_ReadRegister(uint8_t reg, __xdata uint8_t *buf, uint8_t n);
+void SPI_CS_LOW(void) NONBANKED;
+void SPI_CS_HIGH(void) NONBANKED;
+void SPI_DC_LOW(void) NONBANKED;
+void SPI_DC_HIGH(void) NONBANKED;
 void SPI_RST_LOW(void);
 void SPI_RST_HIGH(void);
 
@@ -0,0 +1,23 @@
+/* -----------------------------------------------------------------------
+ * Sleep timer time base
+ *
+ * ST0 must be read first: reading it latches ST1/ST2 so the three
+ * bytes belong to the same count.
+ * ----------------------------------------------------------------------- */
+#include <cc2530.h>
+#include <stdint.h>
+#include "systime.h"
+
+uint32_t systime_now(void)
+{
+    uint32_t t;
+    t  = ST0;
+    t |= (uint16_t)ST1 << 8;
+    t |= (uint32_t)ST2 << 16;
+    return t;
+}
+
+uint32_t systime_elapsed(uint32_t since)
+{
+    return (systime_now() - since) & 0x00FFFFFFUL;
+}
@@ -0,0 +1,19 @@
+#ifndef SYSTIME_H
+#define SYSTIME_H
+
+#include <stdint.h>
+
+/*
+ * Free-running time base from the 32.768 kHz sleep timer.
+ *
+ * The sleep timer is a 24-bit counter that runs from reset and keeps
+ * counting in every power mode, so it needs no init and no interrupt.
+ * It wraps every 512 s; always compare with systime_elapsed().
+ */
+#define SYSTIME_HZ        32768UL
+#define SYSTIME_MS(ms)    ((uint32_t)(ms) * SYSTIME_HZ / 1000)
+
+uint32_t systime_now(void);
+uint32_t systime_elapsed(uint32_t since);
+
+#endif /* SYSTIME_H */
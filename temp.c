@@ -0,0 +1,45 @@
+#include <cc2530.h>
+#include <stdint.h>
+#include "temp.h"
+
+/* -----------------------------------------------------------------------
+ * Single conversion: internal 1.25 V reference, 512 decimation (12 bit),
+ * channel 14 (temperature sensor). Writing ADCCON3 starts it.
+ * ----------------------------------------------------------------------- */
+#define ADC_TEMP_CONV  0x3E
+
+static uint16_t temp_adc(void)
+{
+    uint8_t lo;
+
+    ADCCON3 = ADC_TEMP_CONV;
+    while (!(ADCCON1 & 0x80));        /* EOC */
+    lo = ADCL;
+    return (((uint16_t)ADCH << 8) | lo) >> 4;
+}
+
+int8_t temp_read(void)
+{
+    int16_t sum = 0;
+    int16_t t;
+    uint8_t i;
+
+    /* Route the sensor to the ADC */
+    ATEST = 0x01;
+    TR0   = 0x01;
+
+    temp_adc();                       /* the first one after TR0 is off */
+    for (i = 0; i < TEMP_SAMPLES; i++)
+        sum += temp_adc();
+
+    TR0   = 0x00;
+    ATEST = 0x00;
+
+    /* 4.5 counts per degree */
+    t = (sum / TEMP_SAMPLES - TEMP_ADC_25C) * 2 / 9 + 25 + TEMP_OFFSET_C;
+    if (t < -40)
+        t = -40;
+    if (t > 85)
+        t = 85;
+    return (int8_t)t;
+}
@@ -0,0 +1,23 @@
+#ifndef TEMP_H
+#define TEMP_H
+
+#include <stdint.h>
+
+/*
+ * On-chip temperature sensor, read through the ADC.
+ *
+ * The sensor is uncalibrated: TI quotes 1480 counts (12 bit, 1.25 V
+ * internal reference) at 25 C and 4.5 counts per degree, with a few
+ * degrees of spread between chips. TEMP_OFFSET_C corrects a board
+ * measured against a thermometer.
+ */
+#ifndef TEMP_OFFSET_C
+#define TEMP_OFFSET_C    0
+#endif
+
+#define TEMP_ADC_25C     1480
+#define TEMP_SAMPLES     4        /* ~0.5 ms in total */
+
+int8_t temp_read(void);           /* degrees C */
+
+#endif /* TEMP_H */
@@ -0,0 +1,97 @@
+#include <stdint.h>
+#include "text.h"
+#include "assets.h"
+#include "GxGDEW0213Z16.h"
+#include "fb.h"
+
+__xdata uint8_t text_map[TEXT_ROWS][TEXT_COLS];
+__xdata uint8_t text_attr[TEXT_ROWS];
+
+/* -----------------------------------------------------------------------
+ * Layout
+ *
+ * The panel scans 212 rows of 13 bytes. In landscape a panel row is one
+ * pixel column X of the label and panel byte c holds label pixels
+ * Y = 8 * (12 - c) ... + 7, bottom pixel in bit7. That is exactly one
+ * font column byte of text row 12 - c, so a glyph column goes to the
+ * panel as is.
+ * ----------------------------------------------------------------------- */
+#define FONT_W      ASSET_FONT5X7_W
+#define FONT_FIRST  0x20
+#define HALF_NONE    0
+#define HALF_TOP     1
+#define HALF_BOTTOM  2
+
+/* Which map row draws text row r, and which half of a tall glyph */
+static HOT_VAR uint8_t row_owner[TEXT_ROWS];
+static HOT_VAR uint8_t row_half[TEXT_ROWS];
+
+/* Nibble -> byte with every bit doubled, for TEXT_TALL */
+static __code const uint8_t stretch[16] = {
+    0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+    0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF
+};
+
+static void text_layout(void)
+{
+    uint8_t r;
+
+    for (r = 0; r < TEXT_ROWS; r++) {
+        if (r > 0 && row_half[r - 1] == HALF_TOP) {
+            row_owner[r] = r - 1;
+            row_half[r]  = HALF_BOTTOM;
+        } else {
+            row_owner[r] = r;
+            row_half[r]  = (text_attr[r] & TEXT_TALL) && r < TEXT_ROWS - 1
+                         ? HALF_TOP : HALF_NONE;
+        }
+    }
+}
+
+void text_clear(void)
+{
+    fb_fill(&text_map[0][0], ' ', sizeof(text_map));
+    fb_fill(text_attr, 0, sizeof(text_attr));
+}
+
+/* -----------------------------------------------------------------------
+ * Render panel row y into epd_row, framebuffer polarity (1 = white)
+ * ----------------------------------------------------------------------- */
+void text_row(uint8_t y) NONBANKED
+{
+    uint8_t tx  = y / TEXT_CELL_W;
+    uint8_t gx  = y % TEXT_CELL_W;
+    uint8_t wtx = y / (2 * TEXT_CELL_W);
+    uint8_t wgx = (y % (2 * TEXT_CELL_W)) >> 1;
+    uint8_t c, r, ch, col, cx, cgx;
+    __code const uint8_t *font = assets[ASSET_FONT5X7].data;
+
+    if (y == 0)
+        text_layout();
+
+    for (c = 0; c < EPD_ROW_BYTES; c++) {
+        r  = row_owner[TEXT_ROWS - 1 - c];
+
+        if (text_attr[r] & TEXT_WIDE) {
+            cx  = wtx;
+            cgx = wgx;
+        } else {
+            cx  = tx;
+            cgx = gx;
+        }
+
+        ch  = cx < TEXT_COLS ? text_map[r][cx] : ' ';
+        col = 0;
+        if (cgx < FONT_W && (ch & 0x7F) >= FONT_FIRST)
+            col = font[(uint16_t)((ch & 0x7F) - FONT_FIRST) * FONT_W + cgx];
+
+        switch (row_half[TEXT_ROWS - 1 - c]) {
+        case HALF_TOP:    col = stretch[col & 0x0F]; break;
+        case HALF_BOTTOM: col = stretch[col >> 4];   break;
+        }
+
+        if (ch & TEXT_INVERSE)
+            col = ~col;
+        epd_row[c] = ~col;
+    }
+}
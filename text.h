@@ -0,0 +1,33 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+#include <stdint.h>
+#include "bank.h"
+
+/*
+ * Text mode: a tile map of characters drawn in landscape (212 x 104) with
+ * the font5x7 asset, rendered row by row while the frame is sent to the panel.
+ *
+ * A cell is 6 x 8 pixels (glyph + one blank column/row). A TEXT_TALL row
+ * is drawn at double height and also covers the row below it; a
+ * TEXT_WIDE row at double width uses only the first TEXT_COLS / 2 cells.
+ */
+#define TEXT_CELL_W   6
+#define TEXT_COLS     35              /* 212 / 6 */
+#define TEXT_ROWS     13              /* 104 / 8 */
+#define TEXT_MAP_SIZE (TEXT_COLS * TEXT_ROWS)
+
+/* Row attributes */
+#define TEXT_TALL     0x01
+#define TEXT_WIDE     0x02
+
+/* Cell: character 0x20-0x7F, bit7 = inverse video */
+#define TEXT_INVERSE  0x80
+
+extern __xdata uint8_t text_map[TEXT_ROWS][TEXT_COLS];
+extern __xdata uint8_t text_attr[TEXT_ROWS];
+
+void text_clear(void);
+void text_row(uint8_t y) NONBANKED;  /* epd_row_fn, see EPD_SendRows() */
+
+#endif /* TEXT_H */
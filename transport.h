@@ -0,0 +1,29 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <stdint.h>
+#include "bank.h"
+
+/*
+ * Byte stream the command protocol (uart_rx.c) runs over
+ *
+ *   uart_transport  USART1, uart.c
+ *   link_transport  802.15.4 frames, reassembled by link.c (make LINK=)
+ *
+ * Each transport keeps an RX ring and posts EV_RX (sched.h) when bytes
+ * arrive. The protocol takes a whole command, replies included, from
+ * the transport its first byte came from.
+ *
+ * Called through pointers: one argument at most, NONBANKED (bank.h).
+ */
+typedef struct {
+    uint8_t (*ready)(void) NONBANKED;     /* a byte is waiting */
+    uint8_t (*peek)(void) NONBANKED;
+    uint8_t (*getc)(void) NONBANKED;      /* only when ready() */
+    void    (*putb)(uint8_t b) NONBANKED;
+} transport_t;
+
+extern __code const transport_t uart_transport;
+extern __code const transport_t link_transport;
+
+#endif /* TRANSPORT_H */
@@ -1,6 +1,14 @@
 #include <cc2530.h>
 #include <stdint.h>
 #include <stdarg.h>
+#include "uart.h"
+#include "bank.h"
+#include "sched.h"
+
+/* RX ring, filled by uart_rx_isr(). 8-bit indices wrap by themselves. */
+static __xdata uint8_t rx_ring[UART_RX_RING];
+static volatile __data uint8_t rx_head;
+static __data uint8_t rx_tail;
 
 /* -----------------------------------------------------------------------
  * UART — USART1 Alt.2 (P1_6=TX, P1_7=RX)
@@ -29,20 +37,93 @@ void uart_init(void)
     U1BAUD = 216;                /* BAUD_M */
     U1GCR  = 14;                 /* BAUD_E (bits[4:0]), MSB first = 0 (LSB first for UART) */
 
-    /* Enable receiver */
+    /* Enable receiver, bytes arrive through uart_rx_isr() */
+    rx_head = rx_tail = 0;
     U1CSR |= 0x40;
+    URX1IF = 0;
+    URX1IE = 1;
 }
 
-/* Send one byte, blocking */
+/* -----------------------------------------------------------------------
+ * RX interrupt: one byte into the ring, dropped if it is full
+ * ----------------------------------------------------------------------- */
+void uart_rx_isr(void) __interrupt(URX1_VECTOR)
+{
+    /* fb.c loops may be running with DPTR1 selected. No locals: in the
+     * large models they live in XDATA and are reached through DPTR. */
+#ifndef SIM
+    __asm
+        push    _DPS
+        mov     _DPS, #0
+    __endasm;
+#endif
+
+    URX1IF = 0;
+    if ((uint8_t)(rx_head + 1) != rx_tail)
+        rx_ring[rx_head++] = U1DBUF;
+    else
+        (void)U1DBUF;
+    SCHED_POST(EV_RX);
+
+#ifndef SIM
+    __asm
+        pop     _DPS
+    __endasm;
+#endif
+}
+
+uint8_t uart_rx_ready(void) NONBANKED
+{
+    return rx_head != rx_tail;
+}
+
+uint8_t uart_peek(void) NONBANKED
+{
+    return rx_ring[rx_tail];
+}
+
+/* Send one raw byte, blocking — no newline translation, for binary replies */
+void uart_putb(uint8_t b) NONBANKED
+{
+    U1DBUF = b;
+    while (!(U1CSR & 0x02));    /* wait TX_BYTE flag (bit1) */
+    U1CSR &= ~0x02;             /* clear flag */
+}
+
+/* -----------------------------------------------------------------------
+ * Blocking receive one byte from the RX ring
+ * ----------------------------------------------------------------------- */
+uint8_t uart_getc(void) NONBANKED
+{
+    while (rx_head == rx_tail)
+        ;
+    return rx_ring[rx_tail++];
+}
+
+/* -----------------------------------------------------------------------
+ * Receive N bytes and store into a buffer
+ * ----------------------------------------------------------------------- */
+void uart_read_bytes(__xdata uint8_t *buf, uint16_t len) NONBANKED
+{
+    uint16_t i;
+    for (i = 0; i < len; i++) {
+        buf[i] = uart_getc();
+    }
+}
+
+/* The protocol's view of the UART, see transport.h */
+__code const transport_t uart_transport = {
+    uart_rx_ready, uart_peek, uart_getc, uart_putb
+};
+
+/* Send one character, blocking */
 void uart_putc(char c)
 {
     /* CR+LF on newline (handy for terminals) */
     if (c == '\n')
-        uart_putc('\r');
+        uart_putb('\r');
 
-    U1DBUF = c;
-    while (!(U1CSR & 0x02));    /* wait TX_BYTE flag (bit1) */
-    U1CSR &= ~0x02;             /* clear flag */
+    uart_putb(c);
 }
 
 /* Send null-terminated string */
@@ -1,10 +1,23 @@
 #ifndef UART_H
 #define UART_H
 
+#include <cc2530.h>
 #include <stdint.h>
 #include <stdarg.h>
+#include "bank.h"
+#include "transport.h"
+
+/* RX is interrupt driven: 256 bytes, ~2.8 ms at 921600 baud. Posts
+ * EV_RX (sched.h) for every byte. */
+#define UART_RX_RING 256
 
 void uart_init(void);
+void uart_rx_isr(void) __interrupt(URX1_VECTOR);
+uint8_t uart_rx_ready(void) NONBANKED;
+uint8_t uart_peek(void) NONBANKED;
+void uart_putb(uint8_t b) NONBANKED;
+uint8_t uart_getc(void) NONBANKED;
+void uart_read_bytes(__xdata uint8_t *buf, uint16_t len) NONBANKED;
 void uart_putc(char c);
 void uart_puts(__code const char *s);
 void uart_printf(__code const char *fmt, ...);
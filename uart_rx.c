@@ -3,29 +3,73 @@
 #include "uart.h"
 #include "uart_rx.h"
 #include "GxGDEW0213Z16.h"
+#include "crc32.h"
+#include "boot.h"
+#include "text.h"
+#include "compose.h"
+#include "bench.h"
+#include "sched.h"
+#include "transport.h"
+#include "link.h"
+#include "spi.h"
 
 __xdata uint8_t framebuffer[FRAMEBUFFER_SIZE];
 
 /* -----------------------------------------------------------------------
- * Blocking receive one byte over UART1
+ * Frame hashes
+ *
+ * CRC32 of the frame on the panel and of the frame in `framebuffer`, so
+ * the host can skip uploads/refreshes for frames the tag already has and
+ * verify that an upload arrived intact.
  * ----------------------------------------------------------------------- */
-uint8_t uart_getc(void)
+#define HASH_SHOWN_VALID   0x01
+#define HASH_BUFFER_VALID  0x02
+
+static uint8_t  hash_flags;
+static uint32_t hash_shown;
+static uint32_t hash_buffer;
+
+static void hash_update_buffer(void)
 {
-    uint8_t b;
-    while (!RX_BYTE);   /* SBIT — waits for bit 2 of U1CSR */
-    b = U1DBUF;         /* reading clears RX_BYTE automatically */
-    return b;
+    hash_buffer = CRC32_FINAL(crc32_update(CRC32_INIT, framebuffer,
+                                           FRAMEBUFFER_SIZE));
+    hash_flags |= HASH_BUFFER_VALID;
 }
 
+/* EPD_Clear() shows white, i.e. a framebuffer of all 0xFF. Its CRC32,
+ * from zlib.crc32(b"\xff" * 2756); recompute if FRAMEBUFFER_SIZE changes. */
+#define HASH_CLEAR_FRAME  0x036A5391UL
+
 /* -----------------------------------------------------------------------
- * Receive N bytes and store into a buffer
+ * Transports, see transport.h. Between commands the first with a byte
+ * that may go on is taken; tp stays until the command is done, done_tp
+ * gets the final ACK of a drawing command.
  * ----------------------------------------------------------------------- */
-void uart_read_bytes(__xdata uint8_t *buf, uint16_t len)
+static __code const transport_t * __code const transports[] = {
+#ifndef LINK_LOOPBACK
+    &uart_transport,
+#endif
+#ifdef LINK
+    &link_transport,
+#endif
+};
+#define TRANSPORTS  (sizeof(transports) / sizeof(transports[0]))
+
+static __code const transport_t *tp = &uart_transport;
+static __code const transport_t *done_tp = &uart_transport;
+
+static void reply(uint8_t b)
 {
-    uint16_t i;
-    for (i = 0; i < len; i++) {
-        buf[i] = uart_getc();
-    }
+    tp->putb(b);
+}
+
+/* Little-endian, raw bytes */
+static void reply_u32(uint32_t v)
+{
+    reply((uint8_t)v);
+    reply((uint8_t)(v >> 8));
+    reply((uint8_t)(v >> 16));
+    reply((uint8_t)(v >> 24));
 }
 
 /* -----------------------------------------------------------------------
@@ -34,37 +78,538 @@ void uart_read_bytes(__xdata uint8_t *buf, uint16_t len)
 #define CMD_WRITE_SCREEN 0x57
 #define CMD_CLEAR_SCREEN 0x43
 #define CMD_SEND_BUFFER  0x69
+#define CMD_WRITE_CHANGED 0x77  /* CMD_WRITE_SCREEN, no-op if already shown */
+#define CMD_GET_HASH     0x48
+#define CMD_BOOTLOADER   0x42  /* reset into the serial bootloader */
+#define CMD_BENCH        0x6D  /* cycle counts, BENCH builds only (bench.h) */
+#define CMD_TEXT_MAP     0x54  /* row attrs + whole tile map, see text.h */
+#define CMD_TEXT_PUT     0x74  /* row, col, attr, len, chars */
+#define CMD_TEXT_WRITE   0x44  /* draw the tile map */
+#define CMD_BACKGROUND   0x62  /* index -> ACK/NAK, see compose.h */
+#define CMD_OVERLAYS     0x4F  /* count, {op col w y h, w*h bytes}... */
+#define CMD_COMPOSE      0x63  /* draw background + overlays */
+#define CMD_BATCH        0x5A  /* count, sub-operations -> status record */
+#define CMD_SPI          0x53  /* 0 query, 1 recalibrate -> SPI clock record */
+#define CMD_EPD_SEQ      0x45  /* len u16 -> ACK, panel sequences -> ACK */
+
+/* -----------------------------------------------------------------------
+ * Command state machine
+ *
+ * proto_run() runs on EV_RX and takes what is in the RX rings, it
+ * never waits for bytes: a command is received in steps (proto_step),
+ * each filling rx_left bytes at rx_dst.
+ *
+ * The panel draws in the background (GxGDEW0213Z16.h). While a frame
+ * is sent, commands wait in the ring, the frame's sources must not
+ * change. During the refresh that follows only uploads are taken,
+ * CMD_SEND_BUFFER, CMD_TEXT_MAP and CMD_TEXT_PUT, which answer with
+ * plain ACKs. Everything else waits for the refresh's final ACK (on
+ * EV_EPD_DONE) so replies keep their order.
+ * ----------------------------------------------------------------------- */
+static uint8_t  cmd;                /* command being received */
+static uint8_t  step;
+static __xdata uint8_t *rx_dst;     /* 0: discard */
+static uint16_t rx_left;
+static __xdata uint8_t hdr[5];
+static uint8_t  overlays_left;
+static uint8_t  overlays_ok;
+static uint8_t  batch_count;
+static uint8_t  batch_i;
+static uint8_t  batch_failed;
+static uint8_t  batch_drawing;      /* wait for EV_EPD_DONE */
+static uint16_t batch_left;         /* bytes of the batch not yet received */
+static __xdata uint8_t batch_result[BATCH_MAX];
+
+/* Shown hash once the refresh in progress is done */
+static uint8_t  shown_pending;
+static uint32_t shown_hash;
+
+static void receive(__xdata uint8_t *dst, uint16_t len)
+{
+    rx_dst  = dst;
+    rx_left = len;
+}
+
+static void draw(epd_row_fn row_fn)
+{
+    EPD_SendRows(row_fn);
+    done_tp = tp;
+    hash_flags &= ~HASH_SHOWN_VALID;   /* not a framebuffer frame */
+    shown_pending = 0;
+}
+
+/* Framebuffer to the panel; 0 if only_changed and it is shown already */
+static uint8_t write_frame(uint8_t only_changed)
+{
+    if (!(hash_flags & HASH_BUFFER_VALID))
+        hash_update_buffer();
+    if (only_changed && (hash_flags & HASH_SHOWN_VALID) &&
+        hash_shown == hash_buffer)
+        return 0;
+    EPD_SendFrame(framebuffer);
+    done_tp       = tp;
+    shown_hash    = hash_buffer;
+    shown_pending = 1;
+    return 1;
+}
+
+static void clear_frame(void)
+{
+    EPD_Clear();
+    done_tp       = tp;
+    shown_hash    = HASH_CLEAR_FRAME;
+    shown_pending = 1;
+}
+
+static uint8_t must_wait(uint8_t c)
+{
+    if (EPD_Sending())
+        return 1;
+    if (EPD_Idle())
+        return 0;
+    return c != CMD_SEND_BUFFER && c != CMD_TEXT_MAP && c != CMD_TEXT_PUT;
+}
+
 /* -----------------------------------------------------------------------
- * Wait for a command byte, then receive the framebuffer if needed
+ * CMD_BATCH, see uart_rx.h
+ *
+ * Steps: count and length, then per operation its opcode (B_OP),
+ * arguments (B_ARGS) and payload (B_DATA), which runs it. A drawing
+ * operation holds the batch until EV_EPD_DONE (B_NEXT). After a failed
+ * operation the rest are still received but not run. Every receive is
+ * counted against the length; whatever is left when the batch ends,
+ * normally or not, is discarded, never parsed as commands.
  * ----------------------------------------------------------------------- */
-void uart_process_command(void)
+#define B_COUNT  1
+#define B_OP     2
+#define B_ARGS   3
+#define B_DATA   4
+#define B_NEXT   5
+
+static uint32_t get_u32(__xdata uint8_t *p)
+{
+    return p[0] | ((uint16_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Run a received operation, returns its result */
+static uint8_t batch_run(uint8_t op)
+{
+    switch (op) {
+    case BATCH_UPLOAD:
+    case BATCH_PATCH:
+        hash_flags &= ~HASH_BUFFER_VALID;   /* hashed when needed */
+        break;
+
+    case BATCH_CHECK:
+        if (!(hash_flags & HASH_BUFFER_VALID))
+            hash_update_buffer();
+        if (hash_buffer != get_u32(hdr + 1))
+            return BATCH_MISMATCH;
+        break;
+
+    case BATCH_WRITE:
+    case BATCH_WRITE_CHANGED:
+        if (!write_frame(op == BATCH_WRITE_CHANGED))
+            return BATCH_UNCHANGED;
+        batch_drawing = 1;
+        break;
+
+    case BATCH_CLEAR:
+        clear_frame();
+        batch_drawing = 1;
+        break;
+
+    case BATCH_TEXT:
+        draw(text_row);
+        batch_drawing = 1;
+        break;
+
+    case BATCH_COMPOSE:
+        draw(compose_row);
+        batch_drawing = 1;
+        break;
+
+    case BATCH_SLEEP:
+        EPD_Sleep();
+        break;
+    }
+    return BATCH_OK;
+}
+
+/* ACK, count, results, then hash flags, shown and buffer CRC32 */
+static void batch_status(void)
+{
+    uint8_t i;
+
+    if (!(hash_flags & HASH_BUFFER_VALID))
+        hash_update_buffer();
+    reply(0x06);
+    reply(batch_count);
+    for (i = 0; i < batch_count; i++)
+        reply(batch_result[i]);
+    reply(hash_flags);
+    reply_u32(hash_shown);
+    reply_u32(hash_buffer);
+}
+
+/* receive() within the batch; 0 if it would run past its length */
+static uint8_t batch_receive(__xdata uint8_t *dst, uint16_t len)
+{
+    if (len > batch_left)
+        return 0;
+    batch_left -= len;
+    receive(dst, len);
+    return 1;
+}
+
+/* The rest can't be parsed: BAD for it, status, discard the bytes left */
+static uint8_t batch_abort(void)
 {
-    uint8_t cmd = uart_getc();
+    while (batch_i < batch_count)
+        batch_result[batch_i++] = BATCH_BAD;
+    batch_status();
+    receive(0, batch_left);
+    return 1;
+}
+
+/* Returns 1 when the batch is finished */
+static uint8_t batch_step(uint8_t s)
+{
+    uint8_t  op = hdr[0];
+    uint16_t off, len;
+    __xdata uint8_t *dst;
+
+    switch (s) {
+    case 0:
+        receive(hdr, 3);
+        return 0;
+
+    case B_COUNT:
+        batch_left = hdr[1] | ((uint16_t)hdr[2] << 8);
+        if (op > BATCH_MAX) {
+            reply(0x15);
+            receive(0, batch_left);
+            return 1;
+        }
+        batch_count   = op;
+        batch_i       = 0;
+        batch_failed  = 0;
+        break;
+
+    case B_OP:
+        /* an unknown opcode's length is unknown, so is where the next
+         * one starts */
+        if (op < BATCH_UPLOAD || op > BATCH_SLEEP ||
+            !batch_receive(hdr + 1,
+                           op == BATCH_PATCH || op == BATCH_CHECK ? 4 : 0))
+            return batch_abort();
+        batch_result[batch_i] = batch_failed ? BATCH_NOT_RUN : BATCH_OK;
+        return 0;
+
+    case B_ARGS:
+        if (op == BATCH_UPLOAD) {
+            len = FRAMEBUFFER_SIZE;
+            dst = batch_failed ? 0 : framebuffer;
+        } else if (op == BATCH_PATCH) {
+            off = hdr[1] | ((uint16_t)hdr[2] << 8);
+            len = hdr[3] | ((uint16_t)hdr[4] << 8);
+            if (!batch_failed &&
+                (off > FRAMEBUFFER_SIZE || len > FRAMEBUFFER_SIZE - off))
+                batch_result[batch_i] = BATCH_BAD;
+            dst = batch_result[batch_i] == BATCH_OK ? framebuffer + off : 0;
+        } else {
+            len = 0;
+            dst = 0;
+        }
+        if (!batch_receive(dst, len))
+            return batch_abort();
+        return 0;
 
-    switch(cmd)
+    case B_DATA:
+        if (batch_result[batch_i] == BATCH_OK)
+            batch_result[batch_i] = batch_run(op);
+        if (batch_result[batch_i] == BATCH_BAD ||
+            batch_result[batch_i] == BATCH_MISMATCH)
+            batch_failed = 1;
+        batch_i++;
+        if (batch_drawing) {
+            step = B_NEXT;
+            return 0;
+        }
+        break;
+    }
+
+    /* B_COUNT, B_DATA and B_NEXT: the next operation */
+    if (batch_i == batch_count) {
+        batch_status();
+        receive(0, batch_left);
+        return 1;
+    }
+    step = B_OP;
+    if (!batch_receive(hdr, 1))
+        return batch_abort();
+    return 0;
+}
+
+/* Next step of cmd once the previous receive is complete. Returns with
+ * a new receive set up, or clears cmd when the command is finished. */
+static void proto_step(void)
+{
+    uint8_t s = step++;
+    uint8_t n;
+    uint16_t len;
+    __xdata epd_spi_cal_t *cal;
+
+    switch (cmd)
     {
         case CMD_SEND_BUFFER:
-            uart_putc(0x06);
-            uart_read_bytes(framebuffer, FRAMEBUFFER_SIZE);
-            uart_putc(0x06);
+            if (s == 0) {
+                reply(0x06);
+                receive(framebuffer, FRAMEBUFFER_SIZE);
+                return;
+            }
+            hash_update_buffer();
+            reply(0x06);
             break;
 
         case CMD_WRITE_SCREEN:
-            /* Receive full framebuffer */
-            uart_putc(0x06);
-            EPD_SendFrame(framebuffer);
-            uart_putc(0x06);
+        case CMD_WRITE_CHANGED:
+            reply(0x06);
+            if (!write_frame(cmd == CMD_WRITE_CHANGED))
+                reply(0x06);
             break;
 
         case CMD_CLEAR_SCREEN:
-            // clear screen
-            uart_putc(0x06);
-            EPD_Clear();
-            uart_putc(0x06);
+            reply(0x06);
+            clear_frame();
+            break;
+
+        case CMD_GET_HASH:
+            /* ACK, flags, shown CRC32, buffer CRC32 */
+            if (!(hash_flags & HASH_BUFFER_VALID))
+                hash_update_buffer();
+            reply(0x06);
+            reply(hash_flags);
+            reply_u32(hash_shown);
+            reply_u32(hash_buffer);
+            break;
+
+        case CMD_TEXT_MAP:
+            if (s == 0) {
+                reply(0x06);
+                receive(text_attr, TEXT_ROWS);
+                return;
+            }
+            if (s == 1) {
+                receive(&text_map[0][0], TEXT_MAP_SIZE);
+                return;
+            }
+            reply(0x06);
+            break;
+
+        case CMD_TEXT_PUT:
+            /* row, col, attr, len, then len chars; whatever runs past
+             * the row is dropped */
+            if (s == 0) {
+                reply(0x06);
+                receive(hdr, 4);
+                return;
+            }
+            if (s == 1) {
+                n = 0;
+                if (hdr[0] < TEXT_ROWS) {
+                    text_attr[hdr[0]] = hdr[2];
+                    if (hdr[1] < TEXT_COLS)
+                        n = TEXT_COLS - hdr[1];
+                }
+                if (n > hdr[3])
+                    n = hdr[3];
+                hdr[4] = hdr[3] - n;
+                receive(n ? &text_map[hdr[0]][hdr[1]] : 0, n);
+                return;
+            }
+            if (s == 2) {
+                receive(0, hdr[4]);
+                return;
+            }
+            reply(0x06);
+            break;
+
+        case CMD_TEXT_WRITE:
+            reply(0x06);
+            draw(text_row);
+            break;
+
+        case CMD_BACKGROUND:
+            if (s == 0) {
+                receive(hdr, 1);
+                return;
+            }
+            reply(compose_set_background(hdr[0]) ? 0x06 : 0x15);
+            break;
+
+        case CMD_OVERLAYS:
+            /* count, {op col w y h, w*h bytes}... Replaces all overlays;
+             * the data of a rejected one is still read, then NAK */
+            if (s == 0) {
+                reply(0x06);
+                receive(hdr, 1);
+                return;
+            }
+            if (s == 1) {
+                overlays_left = hdr[0];
+                overlays_ok   = 1;
+                compose_clear_overlays();
+                return;
+            }
+            if (s & 1) {                    /* header received */
+                step   = 2;
+                rx_dst = compose_add_overlay(hdr[0], hdr[1], hdr[2],
+                                             hdr[3], hdr[4]);
+                if (!rx_dst)
+                    overlays_ok = 0;
+                receive(rx_dst, (uint16_t)hdr[2] * hdr[4]);
+                return;
+            }
+            if (overlays_left) {            /* s is 2 from here on */
+                overlays_left--;
+                receive(hdr, 5);
+                return;
+            }
+            reply(overlays_ok ? 0x06 : 0x15);
+            break;
+
+        case CMD_COMPOSE:
+            reply(0x06);
+            draw(compose_row);
+            break;
+
+        case CMD_BATCH:
+            if (!batch_step(s))
+                return;
+            break;
+
+#ifdef BENCH
+        case CMD_BENCH:
+            bench_run();
+            hash_flags &= ~HASH_BUFFER_VALID;   /* fb benchmarks wrote it */
+            break;
+#endif
+
+        case CMD_SPI:
+            /* ACK, state, rate, kHz u16, passed, 0x70 + 0x71 as read */
+            if (s == 0) {
+                receive(hdr, 1);
+                return;
+            }
+            if (hdr[0])
+                EPD_SpiCalibrate();
+            cal = EPD_SpiCal();
+            reply(0x06);
+            reply(cal->state);
+            reply(SPI_Rate());
+            reply((uint8_t)SPI_RateKHz(SPI_Rate()));
+            reply(SPI_RateKHz(SPI_Rate()) >> 8);
+            reply(cal->passed);
+            for (n = 0; n <= EPD_REV_LEN; n++)
+                reply(cal->reg[n]);
+            break;
+
+        case CMD_EPD_SEQ:
+            /* len u16 -> ACK, or NAK if too long or a sequence is
+             * running (try again); len bytes -> ACK, NAK if they don't
+             * parse. len 0 goes back to the built-in sequences. */
+            len = hdr[0] | ((uint16_t)hdr[1] << 8);
+            if (s == 0) {
+                receive(hdr, 2);
+                return;
+            }
+            if (s == 1) {
+                rx_dst = len <= EPD_SEQ_RAM ? EPD_SeqBuffer() : 0;
+                if (!rx_dst) {
+                    reply(0x15);
+                    break;
+                }
+                reply(0x06);
+                receive(rx_dst, len);
+                return;
+            }
+            reply(EPD_SeqLoad(len) ? 0x06 : 0x15);
+            break;
+
+        case CMD_BOOTLOADER:
+            /* The bootloader only talks on the UART, and the reset
+             * would drop a reply still queued on the link */
+            if (tp != &uart_transport) {
+                reply(0x15);
+                break;
+            }
+            reply(0x06);                  /* uart_putb() waits until sent */
+            boot_enter();
             break;
 
         default:
-            uart_printf("Unknown command 0x%02X\n", cmd);
+            reply(0x15);                  /* on the transport it came from */
             break;
     }
+    cmd = 0;
+}
+
+/* EV_RX, and EV_EPD_SENT: a waiting command may go on */
+static void proto_run(void) NONBANKED
+{
+    uint8_t b, i;
+
+#ifdef LINK_LOOPBACK
+    link_tunnel_rx();
+#endif
+    while (1) {
+        if (rx_left) {
+            if (!tp->ready())
+                return;
+            b = tp->getc();
+            if (rx_dst)
+                *rx_dst++ = b;
+            rx_left--;
+        } else if (cmd) {
+            if (batch_drawing)
+                return;
+            proto_step();
+        } else {
+            for (i = 0; i < TRANSPORTS; i++)
+                if (transports[i]->ready() && !must_wait(transports[i]->peek()))
+                    break;
+            if (i == TRANSPORTS)
+                return;
+            tp   = transports[i];
+            cmd  = tp->getc();
+            step = 0;
+            proto_step();
+        }
+    }
+}
+
+/* EV_EPD_DONE: final ACK of the drawing command, or the batch goes on */
+static void proto_epd_done(void) NONBANKED
+{
+    if (shown_pending) {
+        hash_shown    = shown_hash;
+        hash_flags   |= HASH_SHOWN_VALID;
+        shown_pending = 0;
+    }
+    if (batch_drawing)
+        batch_drawing = 0;
+    else
+        done_tp->putb(0x06);
+    proto_run();
+}
+
+void uart_rx_init(void)
+{
+    cmd     = 0;
+    rx_left = 0;
+    sched_on(EV_RX,       proto_run);
+    sched_on(EV_EPD_SENT, proto_run);
+    sched_on(EV_EPD_DONE, proto_epd_done);
 }
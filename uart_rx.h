@@ -6,7 +6,43 @@
 
 #define FRAMEBUFFER_SIZE 2756
 
-void uart_process_command(void);
+/*
+ * CMD_BATCH: count (at most BATCH_MAX), len u16, then count operations
+ * in len bytes, each an opcode, its arguments and its data. No reply
+ * until the last one is done, then one status record:
+ *   ACK, count, count x result, hash flags, shown CRC32, buffer CRC32
+ * A count above BATCH_MAX is answered with NAK instead. However the
+ * batch ends, the rest of its len bytes are read and discarded, so its
+ * data is never taken for commands.
+ *
+ * A drawing operation (write, clear, text, compose) holds the batch
+ * until its refresh is done, while the rest of the batch waits in the
+ * RX ring: only operations without data (sleep, check) may follow it.
+ * A check hashes the buffer if it changed, ~30 ms while the ring holds
+ * ~2.8 ms at 921600 baud: no upload or patch may follow a check.
+ * After a failed operation (BAD, MISMATCH) the rest are not run. An
+ * unknown opcode, or an operation running past len, ends the batch,
+ * its remaining results are BAD.
+ */
+#define BATCH_MAX            32
+
+#define BATCH_UPLOAD         0x01  /* FRAMEBUFFER_SIZE bytes */
+#define BATCH_PATCH          0x02  /* offset u16, len u16, len bytes */
+#define BATCH_CHECK          0x03  /* buffer CRC32 u32, else MISMATCH */
+#define BATCH_WRITE          0x04  /* framebuffer to the panel */
+#define BATCH_WRITE_CHANGED  0x05  /* same, UNCHANGED if already shown */
+#define BATCH_CLEAR          0x06
+#define BATCH_TEXT           0x07  /* draw the tile map (text.h) */
+#define BATCH_COMPOSE        0x08  /* draw background + overlays */
+#define BATCH_SLEEP          0x09  /* panel off now instead of after idle */
+
+#define BATCH_OK             0
+#define BATCH_UNCHANGED      1
+#define BATCH_BAD            2     /* unknown opcode, patch out of range */
+#define BATCH_MISMATCH       3
+#define BATCH_NOT_RUN        4     /* after a failed operation */
+
+void uart_rx_init(void);   /* protocol handlers, see sched.h */
 extern __xdata uint8_t framebuffer[FRAMEBUFFER_SIZE];
 
 #endif
\ No newline at end of file